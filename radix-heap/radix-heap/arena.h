@@ -0,0 +1,265 @@
+#pragma once
+
+#include "bucket_index.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// std::pmr (C++17) - tylko jeli kompilator go udostpnia
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#include <memory_resource>
+#define RADIX_HAS_PMR 1
+#endif
+#endif
+#ifndef RADIX_HAS_PMR
+#define RADIX_HAS_PMR 0
+#endif
+
+namespace radix {
+	/**
+	 * Domylny alokator kontenerw - malloc/free
+	 * Ma reallocate(), wic vector<T> dla typw trywialnie kopiowalnych powiksza bufor przez realloc()
+	 * (due bloki s przemapowywane przez system, bez kopiowania)
+	 */
+	template <class T>
+	struct malloc_allocator {
+		typedef T value_type;
+
+		malloc_allocator() {}
+		template <class U>
+		malloc_allocator(const malloc_allocator<U>&) {}
+
+		T* allocate(const size_t n) {
+			T *res = static_cast<T*>(std::malloc(n * sizeof(T)));
+			if (!res && n) throw std::bad_alloc();
+			return res;
+		}
+
+		// Wyzerowany blok - calloc() (due bloki zerowane przez system przy pierwszym dotkniciu strony)
+		T* allocate_zeroed(const size_t n) {
+			T *res = static_cast<T*>(std::calloc(n, sizeof(T)));
+			if (!res && n) throw std::bad_alloc();
+			return res;
+		}
+
+		// Zmiana wielkoci bloku z zachowaniem zawartoci (tylko dla typw trywialnie kopiowalnych)
+		T* reallocate(T* p, const size_t, const size_t new_n) {
+			T *res = static_cast<T*>(std::realloc(p, new_n * sizeof(T)));
+			if (!res && new_n) throw std::bad_alloc();
+			return res;
+		}
+
+		void deallocate(T* p, const size_t) {
+			std::free(p);
+		}
+	};
+
+	template <class T, class U>
+	bool operator==(const malloc_allocator<T>&, const malloc_allocator<U>&) { return true; }
+	template <class T, class U>
+	bool operator!=(const malloc_allocator<T>&, const malloc_allocator<U>&) { return false; }
+
+	namespace detail {
+		// Czy alokator ma allocate_zeroed(n) - wyzerowany blok bez zapisywania caej pamici?
+		template <class alloc_t, class = void>
+		struct has_allocate_zeroed : std::false_type {};
+
+		template <class alloc_t>
+		struct has_allocate_zeroed<alloc_t,
+			decltype(static_cast<void>(std::declval<alloc_t&>().allocate_zeroed(size_t())))> : std::true_type {};
+
+		// Czy alokator ma reallocate(p, old_n, new_n) - zmiana wielkoci bloku bez kopiowania przez wywoujcego?
+		template <class alloc_t, class = void>
+		struct has_reallocate : std::false_type {};
+
+		template <class alloc_t>
+		struct has_reallocate<alloc_t, decltype(static_cast<void>(std::declval<alloc_t&>().reallocate(
+			std::declval<typename alloc_t::value_type*>(), size_t(), size_t())))> : std::true_type {};
+	}
+
+	/**
+	 * Arena dla kubekw i tablic pomocniczych kolejek
+	 * - pami pochodzi z jednego bloku (slab) alokowanego w konstruktorze, kolejne bloki s
+	 *   dokadane tylko gdy pierwszy si skoczy (kady kolejny co najmniej 2x wikszy)
+	 * - przydziay zaokrglane s do klas wielkoci 2^k i 1.5*2^k (max. ~33% straty),
+	 *   zwolniona pami trafia na list wolnych blokw swojej klasy i jest uywana ponownie
+	 * - pami wraca do systemu dopiero w destruktorze areny
+	 *
+	 * Kolejki tworzone wielokrotnie na tej samej arenie (np. jedna na zapytanie) po pierwszym
+	 * przebiegu nie alokuj ju pamici systemowej - bufory poprzedniej kolejki s na listach wolnych blokw
+	 * Arena nie jest bezpieczna wtkowo - jedna arena na wtek
+	 */
+	class arena {
+	public:
+		/**
+		 * @param bytes wielko pierwszego bloku (np. RadixHeap::memory_estimate())
+		 */
+		explicit arena(const size_t bytes = 0) : _chunks(nullptr), _current(nullptr), _end(nullptr),
+			_last_chunk(0), _system_allocations(0) {
+			_free.fill(nullptr);
+			if (bytes) _add_chunk(bytes);
+		}
+
+		~arena() {
+			while (_chunks) {
+				chunk *next = _chunks->next;
+				std::free(_chunks);
+				_chunks = next;
+			}
+		}
+
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+
+		/**
+		 * Przydzia pamici - bloki s wyrwnane do ALIGNMENT bajtw
+		 * @param bytes ilo bajtw
+		 */
+		void* allocate(const size_t bytes) {
+			const size_t cls = _size_class(bytes);
+			if (free_block *block = _free[cls]) {
+				_free[cls] = block->next;
+				return block;
+			}
+			const size_t size = _class_size(cls);
+			if (static_cast<size_t>(_end - _current) < size) _add_chunk(size);
+			void *res = _current;
+			_current += size;
+			return res;
+		}
+
+		/**
+		 * Zwrcenie pamici na list wolnych blokw
+		 * @param bytes ilo bajtw podana przy przydziale
+		 */
+		void deallocate(void* p, const size_t bytes) {
+			if (!p) return;
+			const size_t cls = _size_class(bytes);
+			free_block *block = static_cast<free_block*>(p);
+			block->next = _free[cls];
+			_free[cls] = block;
+		}
+
+		// Ilo alokacji pamici systemowej (blokw) od utworzenia areny
+		size_t system_allocations() const {
+			return _system_allocations;
+		}
+
+		// Wyrwnanie blokw (minimalna wielko klasy)
+		static const size_t ALIGNMENT = 16;
+	private:
+		struct free_block {
+			free_block *next;
+		};
+
+		// Nagwek bloku systemowego - bloki tworz list zwalnian w destruktorze
+		struct chunk {
+			chunk *next;
+			// Dopenienie nagwka do ALIGNMENT bajtw
+			char padding[ALIGNMENT - sizeof(chunk*)];
+		};
+
+		// Klasa: 2k - wielko 2^(k+4), 2k + 1 - wielko 1.5*2^(k+4) (klasa #1 - 24B - nie jest uywana,
+		// wielkoci wszystkich klas s wielokrotnociami ALIGNMENT)
+		static size_t _size_class(const size_t bytes) {
+			if (bytes <= ALIGNMENT) return 0;
+			const unsigned p = detail::msb64(static_cast<std::uint64_t>(bytes - 1));
+			// 2^p < bytes <= 2^(p + 1), p >= 4
+			if (p == 4) return 2;
+			const size_t cls = 2 * (p - 4);
+			return bytes <= (static_cast<size_t>(3) << (p - 1)) ? cls + 1 : cls + 2;
+		}
+
+		static size_t _class_size(const size_t cls) {
+			return cls % 2 ? (static_cast<size_t>(3) << (cls / 2 + 3)) : (ALIGNMENT << (cls / 2));
+		}
+
+		void _add_chunk(const size_t min_bytes) {
+			// Reszta biecego bloku jest porzucana (wraca do systemu w destruktorze)
+			const size_t bytes = std::max(min_bytes, _last_chunk * 2);
+			chunk *c = static_cast<chunk*>(std::malloc(sizeof(chunk) + bytes));
+			if (!c) throw std::bad_alloc();
+			++_system_allocations;
+			c->next = _chunks;
+			_chunks = c;
+			_current = reinterpret_cast<char*>(c + 1);
+			_end = _current + bytes;
+			_last_chunk = bytes;
+		}
+
+		static const size_t _CLASSES = 2 * (sizeof(size_t) * 8);
+
+		std::array<free_block*, _CLASSES> _free;
+		chunk *_chunks;
+		char *_current;
+		char *_end;
+		size_t _last_chunk;
+		size_t _system_allocations;
+	};
+
+	/**
+	 * Alokator (zgodny z std::allocator_traits) korzystajcy z areny
+	 * Kopie alokatora (take po rebind) wspdziel aren
+	 */
+	template <class T>
+	struct arena_allocator {
+		typedef T value_type;
+		typedef std::true_type propagate_on_container_copy_assignment;
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+
+		explicit arena_allocator(arena& a) : _arena(&a) {}
+		template <class U>
+		arena_allocator(const arena_allocator<U>& other) : _arena(other._arena) {}
+
+		T* allocate(const size_t n) {
+			static_assert(alignof(T) <= arena::ALIGNMENT, "Type alignment exceeds arena alignment");
+			return static_cast<T*>(_arena->allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T* p, const size_t n) {
+			_arena->deallocate(p, n * sizeof(T));
+		}
+
+		arena *_arena;
+	};
+
+	template <class T, class U>
+	bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b) { return a._arena == b._arena; }
+	template <class T, class U>
+	bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b) { return a._arena != b._arena; }
+
+#if RADIX_HAS_PMR
+	/**
+	 * Arena jako std::pmr::memory_resource - pozwala uy jej z std::pmr::polymorphic_allocator
+	 * (i odwrotnie - kolejki przyjmuj polymorphic_allocator z dowolnym memory_resource)
+	 */
+	class arena_resource : public std::pmr::memory_resource {
+	public:
+		explicit arena_resource(arena& a) : _arena(a) {}
+	private:
+		void* do_allocate(const size_t bytes, const size_t alignment) override {
+			if (alignment > arena::ALIGNMENT) throw std::bad_alloc();
+			return _arena.allocate(bytes);
+		}
+
+		void do_deallocate(void* p, const size_t bytes, const size_t) override {
+			_arena.deallocate(p, bytes);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+		arena& _arena;
+	};
+#endif
+}
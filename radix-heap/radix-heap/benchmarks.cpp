@@ -1,10 +1,21 @@
-#define CACHE_MIN 0
 #include <benchmark/benchmark_api.h>
 #include "radix.h"
 #include "dheap.h"
+#include "dijkstra.h"
+#include "dial.h"
+#include "multilevel.h"
+#include "key_traits.h"
+#include "sort.h"
+#include "radix_oop.h"
+#include "huge_pages.h"
 #include <ctime>
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <queue>
 #include <random>
 
 #define setIterationTime() auto end = std::chrono::high_resolution_clock::now(); \
@@ -24,11 +35,56 @@ unsigned* getRandomInts(const unsigned count)
     return res;
 }
 
+/**
+ * Wszystkie kombinacje konfiguracji RadixHeap w jednym przebiegu
+ * Nazwa: L - lookup table, C - cache minimw, S - kubeki SoA, R - zmniejszanie kubekw
+ */
+#define RHEAP_POLICY(name, l, c, s, r) \
+    typedef RadixHeap<unsigned, unsigned, std::uint32_t, radix::heap_policy<l, c, s, r>> name;
+RHEAP_POLICY(RHeap_L0C0S0R0, false, false, false, false)
+RHEAP_POLICY(RHeap_L0C0S0R1, false, false, false, true)
+RHEAP_POLICY(RHeap_L0C0S1R0, false, false, true, false)
+RHEAP_POLICY(RHeap_L0C0S1R1, false, false, true, true)
+RHEAP_POLICY(RHeap_L0C1S0R0, false, true, false, false)
+RHEAP_POLICY(RHeap_L0C1S0R1, false, true, false, true)
+RHEAP_POLICY(RHeap_L0C1S1R0, false, true, true, false)
+RHEAP_POLICY(RHeap_L0C1S1R1, false, true, true, true)
+RHEAP_POLICY(RHeap_L1C0S0R0, true, false, false, false)
+RHEAP_POLICY(RHeap_L1C0S0R1, true, false, false, true)
+RHEAP_POLICY(RHeap_L1C0S1R0, true, false, true, false)
+RHEAP_POLICY(RHeap_L1C0S1R1, true, false, true, true)
+RHEAP_POLICY(RHeap_L1C1S0R0, true, true, false, false)
+RHEAP_POLICY(RHeap_L1C1S0R1, true, true, false, true)
+RHEAP_POLICY(RHeap_L1C1S1R0, true, true, true, false)
+RHEAP_POLICY(RHeap_L1C1S1R1, true, true, true, true)
+
+// Rejestracja benchmarku dla konfiguracji z lookup table / dla wszystkich konfiguracji
+#define RHEAP_LOOKUP_POLICIES(bench, max) \
+    BENCHMARK_TEMPLATE(bench, RHeap_L1C0S0R0)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L1C0S0R1)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L1C0S1R0)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L1C0S1R1)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L1C1S0R0)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L1C1S0R1)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L1C1S1R0)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L1C1S1R1)->Range(64, max)->UseManualTime()->Complexity();
+#define RHEAP_ALL_POLICIES(bench, max) \
+    RHEAP_LOOKUP_POLICIES(bench, max) \
+    BENCHMARK_TEMPLATE(bench, RHeap_L0C0S0R0)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L0C0S0R1)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L0C0S1R0)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L0C0S1R1)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L0C1S0R0)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L0C1S0R1)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L0C1S1R0)->Range(64, max)->UseManualTime()->Complexity(); \
+    BENCHMARK_TEMPLATE(bench, RHeap_L0C1S1R1)->Range(64, max)->UseManualTime()->Complexity();
+
+template<class Q>
 void RHeapPush(benchmark::State& state) {
     auto ints = getRandomInts(state.range(0));
 
     while (state.KeepRunning()) {
-        RadixHeap<unsigned, unsigned> heap(state.range(0));
+        Q heap(state.range(0));
 
         auto start = std::chrono::high_resolution_clock::now();
         for (auto i = 0; i < state.range(0); ++i)
@@ -41,13 +97,41 @@ void RHeapPush(benchmark::State& state) {
     state.SetComplexityN(state.iterations() * state.range(0));
     state.SetItemsProcessed(state.iterations() * state.range(0));
 }
-BENCHMARK(RHeapPush)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+RHEAP_ALL_POLICIES(RHeapPush, 8 << 16)
+
+// Wstawianie wszystkich elementw naraz - build() (zliczanie + rozrzucenie, kilka wtkw dla duych n)
+template<class Q>
+void RHeapBuild(benchmark::State& state) {
+    const unsigned count = static_cast<unsigned>(state.range(0));
+    auto ints = getRandomInts(count);
+    std::vector<unsigned> values(count);
+    for (unsigned i = 0; i < count; ++i) values[i] = i;
+
+    while (state.KeepRunning()) {
+        Q heap(count);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        heap.build(values.data(), ints, count);
+        setIterationTime()
+    }
+    delete[] ints;
 
+    state.SetLabel("Heap build");
+    state.SetComplexityN(state.iterations() * count);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(RHeapBuild, RHeap_L1C1S0R0)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(RHeapBuild, RHeap_L0C0S0R0)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(RHeapBuild, RHeap_L1C1S1R0)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(RHeapPush, RHeap_L1C1S0R0)->Range(8 << 18, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(RHeapPush, RHeap_L0C0S0R0)->Range(8 << 18, 8 << 18)->UseManualTime()->Complexity();
+
+template<class Q>
 void RHeapPop(benchmark::State& state) {
     auto ints = getRandomInts(state.range(0));
 
     while(state.KeepRunning()) {
-        RadixHeap<unsigned, unsigned> heap(state.range(0));
+        Q heap(state.range(0));
         for (auto i = 0; i < state.range(0); ++i) 
             heap.push(i, ints[i]);
 
@@ -62,8 +146,9 @@ void RHeapPop(benchmark::State& state) {
     state.SetComplexityN(state.iterations() * state.range(0));
     state.SetItemsProcessed(state.iterations() * state.range(0));
 }
-BENCHMARK(RHeapPop)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+RHEAP_ALL_POLICIES(RHeapPop, 8 << 16)
 
+template<class Q>
 void RHeapReducePriority(benchmark::State& state) {
     auto values = getRandomInts(state.range(0));
     auto minimum = std::numeric_limits<unsigned>::max();
@@ -72,7 +157,7 @@ void RHeapReducePriority(benchmark::State& state) {
 
     auto processed = 0;
     while (state.KeepRunning()) {
-        RadixHeap<unsigned, unsigned> heap(state.range(0));
+        Q heap(state.range(0));
         for (auto i = 0; i < state.range(0); ++i) 
             heap.push(i, values[i]);
 
@@ -91,7 +176,7 @@ void RHeapReducePriority(benchmark::State& state) {
     state.SetComplexityN(processed);
     state.SetItemsProcessed(processed);
 }
-BENCHMARK(RHeapReducePriority)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+RHEAP_LOOKUP_POLICIES(RHeapReducePriority, 8 << 18)
 
 
 /**
@@ -130,6 +215,465 @@ BENCHMARK_TEMPLATE(DHeapReducePriority, dheap<>)->Range(64, 8 << 16)->UseManualT
 BENCHMARK_TEMPLATE(DHeapReducePriority, dheap<3>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
 BENCHMARK_TEMPLATE(DHeapReducePriority, dheap<4>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
 BENCHMARK_TEMPLATE(DHeapReducePriority, dheap<5>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DHeapReducePriority, dheap<8>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DHeapReducePriority, dheap<16>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+
+// Push + pop wszystkich elementw (losowe klucze) - tu liczy si wybr dziecka przy zejciu w pop()
+template<class Q>
+void DHeapPushPop(benchmark::State& state) {
+    auto ints = getRandomInts(state.range(0));
+
+    while (state.KeepRunning()) {
+        Q heap(state.range(0));
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto i = 0; i < state.range(0); ++i)
+            heap.push(i, ints[i]);
+        for (auto i = 0; i < state.range(0); ++i)
+            benchmark::DoNotOptimize(heap.pop());
+        setIterationTime()
+    }
+    delete[] ints;
+
+    state.SetLabel("D-ary push + pop");
+    state.SetComplexityN(state.iterations() * state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(DHeapPushPop, dheap<2>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DHeapPushPop, dheap<3>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DHeapPushPop, dheap<4>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DHeapPushPop, dheap<5>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DHeapPushPop, dheap<8>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DHeapPushPop, dheap<16>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DHeapPushPop, RHeap_L0C0S0R0)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DHeapPushPop, radix::multilevel_heap<unsigned, unsigned>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+
+/**
+ * Model "hold" z 64-bitowymi znacznikami czasu (symulacja zdarze): n zdarze w kolejce, kade zdjcie
+ * minimum wstawia zdarzenie pniejsze o losowe opnienie < 2^32 - klucze rni si od ostatnio usunitego
+ * na wielu bitach, wic RadixHeap przenosi elementy wielokrotnie, a multilevel_heap najwyej kilka razy
+ */
+template<class Q>
+void TimestampHold(benchmark::State& state) {
+    const unsigned n = static_cast<unsigned>(state.range(0)), HOLDS = 4 * n;
+    std::mt19937_64 gen(5);
+    std::vector<std::uint64_t> delays(n + HOLDS);
+    for (auto& delay : delays)
+        delay = gen() & 0xffffffffu;
+
+    while (state.KeepRunning()) {
+        Q heap(n);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (unsigned i = 0; i < n; ++i)
+            heap.push(i, delays[i]);
+        for (unsigned i = 0; i < HOLDS; ++i) {
+            const auto el = heap.pop();
+            heap.push(el.value, el.key + delays[n + i]);
+        }
+        setIterationTime()
+    }
+
+    state.SetLabel("64-bit timestamps, hold");
+    state.SetComplexityN(state.iterations() * HOLDS);
+    state.SetItemsProcessed(state.iterations() * HOLDS);
+}
+BENCHMARK_TEMPLATE(TimestampHold, RadixHeap<unsigned, std::uint64_t>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(TimestampHold, radix::multilevel_heap<unsigned, std::uint64_t, 2>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(TimestampHold, radix::multilevel_heap<unsigned, std::uint64_t, 4>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(TimestampHold, radix::multilevel_heap<unsigned, std::uint64_t, 5>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+
+
+/**
+ * radix::lookup_queue (CRTP) z indeksem tablicowym i haszujcym - porwnanie z RadixHeap
+ */
+typedef radix::lookup_queue<unsigned, unsigned, std::vector<std::pair<unsigned, unsigned>>,
+    radix::dense_lookup<unsigned, unsigned>> DenseLookupQueue;
+typedef radix::lookup_queue<unsigned, unsigned> HashLookupQueue;
+
+template<class Q>
+void LookupQueuePush(benchmark::State& state) {
+    auto ints = getRandomInts(state.range(0));
+
+    while (state.KeepRunning()) {
+        Q heap(state.range(0));
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto i = 0; i < state.range(0); ++i)
+            heap.push(i, ints[i]);
+        setIterationTime()
+    }
+    delete[] ints;
+
+    state.SetLabel("Lookup queue push");
+    state.SetComplexityN(state.iterations() * state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(LookupQueuePush, DenseLookupQueue)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(LookupQueuePush, HashLookupQueue)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+
+template<class Q>
+void LookupQueuePop(benchmark::State& state) {
+    auto ints = getRandomInts(state.range(0));
+
+    while (state.KeepRunning()) {
+        Q heap(state.range(0));
+        for (auto i = 0; i < state.range(0); ++i)
+            heap.push(i, ints[i]);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto i = 0; i < state.range(0); ++i)
+            benchmark::DoNotOptimize(heap.pop());
+        setIterationTime()
+    }
+    delete[] ints;
+
+    state.SetLabel("Lookup queue pop");
+    state.SetComplexityN(state.iterations() * state.range(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(LookupQueuePop, DenseLookupQueue)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(LookupQueuePop, HashLookupQueue)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+
+template<class Q>
+void LookupQueueReducePriority(benchmark::State& state) {
+    auto values = getRandomInts(state.range(0));
+    auto minimum = std::numeric_limits<unsigned>::max();
+    for (auto i = 0; i < state.range(0); ++i)
+        minimum = values[i] < minimum ? values[i] : minimum;
+
+    auto processed = 0;
+    while (state.KeepRunning()) {
+        Q heap(state.range(0));
+        for (auto i = 0; i < state.range(0); ++i)
+            heap.push(i, values[i]);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto i = 0; i < state.range(0); ++i) {
+            if (values[i] > minimum) {
+                heap.change_priority(i, values[i] -= 1);
+                ++processed;
+            }
+        }
+        setIterationTime()
+    }
+    delete[] values;
+
+    state.SetLabel("Lookup queue reduce priority");
+    state.SetComplexityN(processed);
+    state.SetItemsProcessed(processed);
+}
+BENCHMARK_TEMPLATE(LookupQueueReducePriority, DenseLookupQueue)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(LookupQueueReducePriority, HashLookupQueue)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+
+
+/**
+ * Dijkstra na losowym grafie (CSR, ~4 krawdzie na wierzchoek)
+ * Przepustowo kolejki w algorytmie, dla ktrego bya projektowana
+ */
+graph::csr_graph<> getRandomGraph(const unsigned vertices, const unsigned max_weight = 1 << 16)
+{
+    const unsigned edge_count = vertices * 4;
+    auto ints = getRandomInts(edge_count * 3);
+    std::vector<graph::csr_graph<>::edge> edges(edge_count);
+    for (unsigned i = 0; i < edge_count; ++i)
+        edges[i] = { ints[3 * i] % vertices, ints[3 * i + 1] % vertices, ints[3 * i + 2] % max_weight };
+    delete[] ints;
+    return graph::csr_graph<>::from_edges(vertices, edges);
+}
+
+template<class Q>
+void DijkstraRandomGraph(benchmark::State& state) {
+    const auto g = getRandomGraph(state.range(0));
+    std::vector<unsigned> dist(g.vertices()), pred(g.vertices());
+
+    while (state.KeepRunning()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        benchmark::DoNotOptimize(graph::dijkstra<Q>(g, 0u, dist.data(), pred.data()));
+        setIterationTime()
+    }
+
+    state.SetLabel("Dijkstra");
+    state.SetComplexityN(state.iterations() * g.edges());
+    state.SetItemsProcessed(state.iterations() * g.edges());
+}
+RHEAP_LOOKUP_POLICIES(DijkstraRandomGraph, 8 << 16)
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, dheap<>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, dheap<4>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, dheap<8>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, dheap<16>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, DenseLookupQueue)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, HashLookupQueue)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, radix::dial_queue<>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, radix::multilevel_heap<unsigned, unsigned>)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+
+/**
+ * Dijkstra z maymi wagami krawdzi (C = 100, np. odlegoci zaokrglone do 10m) - tu kolejka Diala
+ * nie ma redystrybucji, a RadixHeap wci przenosi elementy midzy kubekami
+ */
+template<class Q>
+void DijkstraSmallWeights(benchmark::State& state) {
+    const auto g = getRandomGraph(state.range(0), 100);
+    std::vector<unsigned> dist(g.vertices()), pred(g.vertices());
+
+    while (state.KeepRunning()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        benchmark::DoNotOptimize(graph::dijkstra<Q>(g, 0u, dist.data(), pred.data()));
+        setIterationTime()
+    }
+
+    state.SetLabel("Dijkstra (C = 100)");
+    state.SetComplexityN(state.iterations() * g.edges());
+    state.SetItemsProcessed(state.iterations() * g.edges());
+}
+BENCHMARK_TEMPLATE(DijkstraSmallWeights, RHeap_L1C1S0R0)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraSmallWeights, dheap<4>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraSmallWeights, DenseLookupQueue)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraSmallWeights, radix::dial_queue<>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraSmallWeights, radix::multilevel_heap<unsigned, unsigned>)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+
+/**
+ * Dijkstra z wagami float - radix heap przez key_traits (mapped_queue) vs kopiec porwnujcy
+ * Punkt odniesienia: std::priority_queue z "leniwym" usuwaniem (reduce_priority wstawia duplikat,
+ * nieaktualne wpisy s zdejmowane i pomijane przez graph::dijkstra)
+ */
+struct LazyFloatHeap {
+    struct element {
+        float key;
+        unsigned value;
+        bool operator>(const element& other) const { return key > other.key; }
+    };
+
+    explicit LazyFloatHeap(const size_t) {}
+    void push(const unsigned value, const float key) { _heap.push(element{ key, value }); }
+    void reduce_priority(const unsigned value, const float key) { push(value, key); }
+    element pop() {
+        const element res = _heap.top();
+        _heap.pop();
+        return res;
+    }
+    bool empty() const { return _heap.empty(); }
+
+private:
+    std::priority_queue<element, std::vector<element>, std::greater<element>> _heap;
+};
+
+typedef radix::mapped_queue<float, RadixHeap<unsigned, radix::key_bits_t<float>>> FloatRHeap;
+typedef radix::mapped_queue<float, radix::multilevel_heap<unsigned, radix::key_bits_t<float>>> FloatMultilevelHeap;
+
+template<class Q>
+void DijkstraFloatWeights(benchmark::State& state) {
+    const auto ig = getRandomGraph(state.range(0));
+    std::vector<graph::csr_graph<float>::edge> edges;
+    for (unsigned v = 0; v < ig.vertices(); ++v)
+        for (size_t e = ig.begin(v); e < ig.end(v); ++e)
+            edges.push_back({ v, ig.target(e), ig.weight(e) / 16.f });
+    const auto g = graph::csr_graph<float>::from_edges(ig.vertices(), edges);
+    std::vector<float> dist(g.vertices());
+    std::vector<unsigned> pred(g.vertices());
+
+    while (state.KeepRunning()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        benchmark::DoNotOptimize(graph::dijkstra<Q>(g, 0u, dist.data(), pred.data()));
+        setIterationTime()
+    }
+
+    state.SetLabel("Dijkstra (float)");
+    state.SetComplexityN(state.iterations() * g.edges());
+    state.SetItemsProcessed(state.iterations() * g.edges());
+}
+BENCHMARK_TEMPLATE(DijkstraFloatWeights, LazyFloatHeap)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraFloatWeights, FloatRHeap)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraFloatWeights, FloatMultilevelHeap)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+
+/**
+ * Dijkstra z kolejk tworzon dla kadego zapytania na wsplnej arenie
+ * Po pierwszym zapytaniu kubeki i lookup table nie alokuj pamici systemowej
+ */
+typedef RadixHeap<unsigned, unsigned, std::uint32_t, radix::dijkstra_policy, radix::arena_allocator<char>> ArenaRHeap;
+
+void DijkstraRandomGraphArena(benchmark::State& state) {
+    const auto g = getRandomGraph(state.range(0));
+    std::vector<unsigned> dist(g.vertices()), pred(g.vertices());
+    radix::arena arena(ArenaRHeap::memory_estimate(g.vertices()));
+
+    while (state.KeepRunning()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        ArenaRHeap heap(g.vertices(), radix::arena_allocator<char>(arena));
+        benchmark::DoNotOptimize(graph::dijkstra(heap, g, 0u, dist.data(), pred.data()));
+        setIterationTime()
+    }
+
+    state.SetLabel("Dijkstra (arena)");
+    state.SetComplexityN(state.iterations() * g.edges());
+    state.SetItemsProcessed(state.iterations() * g.edges());
+}
+BENCHMARK(DijkstraRandomGraphArena)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+
+/**
+ * Dijkstra z jedn kolejk dla wszystkich zapyta - reset() zamiast konstrukcji
+ * (bez inicjalizacji lookup table dla wszystkich wierzchokw przy kadym zapytaniu)
+ */
+template<class Q>
+void DijkstraRandomGraphReuse(benchmark::State& state) {
+    const auto g = getRandomGraph(state.range(0));
+    std::vector<unsigned> dist(g.vertices()), pred(g.vertices());
+    Q heap(g.vertices());
+
+    while (state.KeepRunning()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        benchmark::DoNotOptimize(graph::dijkstra(heap, g, 0u, dist.data(), pred.data()));
+        heap.reset();
+        setIterationTime()
+    }
+
+    state.SetLabel("Dijkstra (reset)");
+    state.SetComplexityN(state.iterations() * g.edges());
+    state.SetItemsProcessed(state.iterations() * g.edges());
+}
+BENCHMARK_TEMPLATE(DijkstraRandomGraphReuse, RHeap_L1C1S0R0)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraphReuse, DenseLookupQueue)->Range(64, 8 << 16)->UseManualTime()->Complexity();
+
+/**
+ * Due grafy (lookup table/pozycje rzdu dziesitek MB, losowy dostp wg numeru wierzchoka) -
+ * zakres, w ktrym dominuj chybienia w TLB; porwnanie zwykych i duych stron
+ */
+typedef RadixHeap<unsigned, unsigned, std::uint32_t, radix::dijkstra_policy, radix::huge_page_allocator<char>> HugePageRHeap;
+typedef dheap<4, radix::huge_page_allocator<char>> HugePageDHeap;
+
+// Zmiana priorytetu losowych wierzchokw w zbudowanym kopcu - losowy dostp do lookup table i kubekw
+template<class Q>
+void RHeapRandomReducePriority(benchmark::State& state) {
+    const unsigned count = static_cast<unsigned>(state.range(0));
+    auto values = getRandomInts(count);
+    auto order = getRandomInts(count);
+    Q heap(count);
+    for (unsigned i = 0; i < count; ++i)
+        heap.push(i, values[i] |= 1u << 30);
+
+    while (state.KeepRunning()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (unsigned i = 0; i < count; ++i) {
+            const unsigned v = order[i] % count;
+            heap.reduce_priority(v, --values[v]);
+        }
+        setIterationTime()
+    }
+    delete[] values;
+    delete[] order;
+
+    state.SetLabel("Heap random reduce priority");
+    state.SetComplexityN(state.iterations() * count);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK_TEMPLATE(RHeapRandomReducePriority, RHeap_L1C1S0R0)->Range(1 << 16, 1 << 22)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(RHeapRandomReducePriority, HugePageRHeap)->Range(1 << 16, 1 << 22)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, RHeap_L1C1S0R0)->Range(1 << 20, 1 << 22)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, HugePageRHeap)->Range(1 << 20, 1 << 22)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, dheap<4>)->Range(1 << 20, 1 << 22)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(DijkstraRandomGraph, HugePageDHeap)->Range(1 << 20, 1 << 22)->UseManualTime()->Complexity();
+
+/**
+ * Sortowanie: radix_heap_sort / sorted_drain vs std::sort i zwyky LSD radix sort (cyfry 8-bitowe)
+ * Wejcia: losowe klucze 32-bitowe oraz prawie posortowane 64-bitowe znaczniki czasu (opnienie < TIMESTAMP_LAG)
+ */
+struct StdSort {
+    template<class T>
+    static void sort(const T* in, const size_t n, T* out) {
+        std::copy(in, in + n, out);
+        std::sort(out, out + n);
+    }
+};
+
+struct LsdRadixSort {
+    template<class T>
+    static void sort(const T* in, const size_t n, T* out) {
+        std::vector<T> tmp(n);
+        const T* src = in;
+        // Parzysta ilo przebiegw - ostatni zapisuje do out
+        T* dst = sizeof(T) % 2 ? out : tmp.data();
+        for (unsigned shift = 0; shift < sizeof(T) * 8; shift += 8) {
+            size_t counts[257] = {};
+            for (size_t i = 0; i < n; ++i)
+                ++counts[((src[i] >> shift) & 0xFF) + 1];
+            for (unsigned d = 0; d < 256; ++d)
+                counts[d + 1] += counts[d];
+            for (size_t i = 0; i < n; ++i)
+                dst[counts[(src[i] >> shift) & 0xFF]++] = src[i];
+            src = dst;
+            dst = dst == out ? tmp.data() : out;
+        }
+    }
+};
+
+struct RadixHeapSort {
+    template<class T>
+    static void sort(const T* in, const size_t n, T* out) {
+        radix::radix_heap_sort(in, n, out);
+    }
+};
+
+const std::uint64_t TIMESTAMP_LAG = 1 << 12;
+
+// Strumie - wypisywanie do granicy najnowszy klucz - TIMESTAMP_LAG, w kubekach tylko okno niewypisanych
+struct StreamingDrain {
+    template<class T>
+    static void sort(const T* in, const size_t n, T* out) {
+        radix::sorted_drain<T> drain;
+        T newest = 0;
+        for (size_t i = 0; i < n; ++i) {
+            drain.push(in[i]);
+            newest = std::max(newest, in[i]);
+            if (newest >= TIMESTAMP_LAG) out = drain.drain_until(newest - TIMESTAMP_LAG, out);
+        }
+        drain.drain(out);
+    }
+};
+
+template<class S>
+void SortRandomKeys(benchmark::State& state) {
+    const size_t n = state.range(0);
+    auto ints = getRandomInts(n);
+    std::vector<unsigned> out(n);
+
+    while (state.KeepRunning()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        S::sort(ints, n, out.data());
+        setIterationTime()
+    }
+    delete[] ints;
+
+    state.SetLabel("Sort random 32-bit keys");
+    state.SetComplexityN(state.iterations() * n);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(SortRandomKeys, StdSort)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(SortRandomKeys, LsdRadixSort)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(SortRandomKeys, RadixHeapSort)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+
+template<class S>
+void SortTimestamps(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::mt19937_64 gen(7);
+    std::vector<std::uint64_t> stamps(n), out(n);
+    const std::uint64_t base = static_cast<std::uint64_t>(std::time(nullptr)) * 1000000;
+    for (size_t i = 0; i < n; ++i)
+        stamps[i] = base + i * 16 + gen() % TIMESTAMP_LAG;
+
+    while (state.KeepRunning()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        S::sort(stamps.data(), n, out.data());
+        setIterationTime()
+    }
+
+    state.SetLabel("Sort nearly sorted 64-bit timestamps");
+    state.SetComplexityN(state.iterations() * n);
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(SortTimestamps, StdSort)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(SortTimestamps, LsdRadixSort)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(SortTimestamps, RadixHeapSort)->Range(64, 8 << 18)->UseManualTime()->Complexity();
+BENCHMARK_TEMPLATE(SortTimestamps, StreamingDrain)->Range(64, 8 << 18)->UseManualTime()->Complexity();
 
 
 BENCHMARK_MAIN()
\ No newline at end of file
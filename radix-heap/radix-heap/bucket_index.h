@@ -0,0 +1,178 @@
+#pragma once
+
+#include "cpu.h"
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <type_traits>
+#if __cplusplus >= 202002L
+#include <bit>
+#endif
+
+namespace radix {
+	namespace detail {
+		/**
+		 * Numer najwyszego ustawionego bitu
+		 * Wywoywane wycznie dla x != 0 (dla 0 zarwno BSR jak i __builtin_clz daj nieokrelony wynik)
+		 */
+		inline unsigned msb32(const std::uint32_t x) {
+#if defined(_MSC_VER) && RADIX_X86
+			if (cpu::features<>::lzcnt) return 31 - __lzcnt(x);
+			unsigned long res;
+			_BitScanReverse(&res, x);
+			return res;
+#elif RADIX_X86 && !defined(__LZCNT__)
+			// Kompilator sam z siebie wygeneruje BSR, LZCNT wstawiamy rcznie, eby nie wymaga -mlzcnt
+			if (cpu::features<>::lzcnt) {
+				std::uint32_t zeros;
+				__asm__("lzcnt %1, %0" : "=r"(zeros) : "rm"(x) : "cc");
+				return 31 - zeros;
+			}
+			return 31 ^ __builtin_clz(x);
+#elif defined(__GNUC__) || defined(__clang__)
+			return 31 ^ __builtin_clz(x);
+#elif defined(__cpp_lib_bitops)
+			return 31 - std::countl_zero(x);
+#else
+			unsigned res = 0;
+			for (std::uint32_t tmp = x; tmp >>= 1; ++res);
+			return res;
+#endif
+		}
+
+		inline unsigned msb64(const std::uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+			if (cpu::features<>::lzcnt) return 63 - static_cast<unsigned>(__lzcnt64(x));
+			unsigned long res;
+			_BitScanReverse64(&res, x);
+			return res;
+#elif RADIX_X86 && defined(__x86_64__) && !defined(__LZCNT__)
+			if (cpu::features<>::lzcnt) {
+				std::uint64_t zeros;
+				__asm__("lzcnt %1, %0" : "=r"(zeros) : "rm"(x) : "cc");
+				return 63 - static_cast<unsigned>(zeros);
+			}
+			return 63 ^ __builtin_clzll(x);
+#elif (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+			return 63 ^ __builtin_clzll(x);
+#elif defined(__cpp_lib_bitops)
+			return 63 - std::countl_zero(x);
+#else
+			// Platformy 32-bitowe - skadamy wynik z dwch powek
+			const std::uint32_t high = static_cast<std::uint32_t>(x >> 32);
+			return high ? 32 + msb32(high) : msb32(static_cast<std::uint32_t>(x));
+#endif
+		}
+	}
+
+	namespace detail {
+		/**
+		 * Numer najniszego ustawionego bitu (x != 0)
+		 * BSF/TZCNT daj ten sam wynik dla x != 0, wic nie ma potrzeby sprawdzania CPU
+		 */
+		inline unsigned lsb32(const std::uint32_t x) {
+#if defined(_MSC_VER) && RADIX_X86
+			unsigned long res;
+			_BitScanForward(&res, x);
+			return res;
+#elif defined(__GNUC__) || defined(__clang__)
+			return __builtin_ctz(x);
+#elif defined(__cpp_lib_bitops)
+			return std::countr_zero(x);
+#else
+			unsigned res = 0;
+			for (std::uint32_t tmp = x; !(tmp & 1); tmp >>= 1) ++res;
+			return res;
+#endif
+		}
+
+		inline unsigned lsb64(const std::uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+			unsigned long res;
+			_BitScanForward64(&res, x);
+			return res;
+#elif (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+			return __builtin_ctzll(x);
+#elif defined(__cpp_lib_bitops)
+			return std::countr_zero(x);
+#else
+			const std::uint32_t low = static_cast<std::uint32_t>(x);
+			return low ? lsb32(low) : 32 + lsb32(static_cast<std::uint32_t>(x >> 32));
+#endif
+		}
+	}
+
+	/**
+	 * Wyznaczanie numeru kubeka dla klucza
+	 * Numer kubeka to numer najwyszego bitu rnicego klucz od ostatnio usunitej wartoci + 1,
+	 * kubeek #0 jest zarezerwowany dla elementw rwnych ostatnio usunitej wartoci
+	 * Niezalenie od instrukcji (LZCNT/BSR) numeracja kubekw jest taka sama
+	 *
+	 * Specjalizacje dla kluczy 8/16/32/64-bitowych, klucze do 32 bitw liczone s na 32-bitowym rejestrze
+	 */
+	template <class key_t, size_t bytes = sizeof(key_t)>
+	struct bucket_index {
+		static_assert(bytes <= 4, "Unsupported key width");
+		static_assert(std::is_integral<key_t>::value && std::is_unsigned<key_t>::value,
+			"Key must be unsigned integer type");
+
+		// Ilo bitw klucza
+		static const size_t BITS = sizeof(key_t) * CHAR_BIT;
+		// Ilo kubekw - jeden na kady bit + kubeek #0
+		static const size_t BUCKETS = BITS + 1;
+
+		static size_t find(const key_t key, const key_t last_deleted) {
+			if (key == last_deleted) return 0;
+			return detail::msb32(static_cast<std::uint32_t>(key ^ last_deleted)) + 1;
+		}
+
+		/**
+		 * Maska niepustych kubekw #1..#BITS (kubeek #0 jest sprawdzany bezporednio)
+		 * Bit (i - 1) odpowiada kubekowi #i
+		 */
+		typedef std::uint32_t mask_t;
+
+		static mask_t bit(const size_t bucket) {
+			return static_cast<mask_t>(1) << (bucket - 1);
+		}
+
+		// Pierwszy niepusty kubeek (mask != 0)
+		static size_t first(const mask_t mask) {
+			return detail::lsb32(mask) + 1;
+		}
+	};
+
+	// Klucze 64-bitowe
+	template <class key_t>
+	struct bucket_index<key_t, 8> {
+		static_assert(std::is_integral<key_t>::value && std::is_unsigned<key_t>::value,
+			"Key must be unsigned integer type");
+
+		static const size_t BITS = sizeof(key_t) * CHAR_BIT;
+		static const size_t BUCKETS = BITS + 1;
+
+		static size_t find(const key_t key, const key_t last_deleted) {
+			if (key == last_deleted) return 0;
+			return detail::msb64(static_cast<std::uint64_t>(key ^ last_deleted)) + 1;
+		}
+
+		typedef std::uint64_t mask_t;
+
+		static mask_t bit(const size_t bucket) {
+			return static_cast<mask_t>(1) << (bucket - 1);
+		}
+
+		static size_t first(const mask_t mask) {
+			return detail::lsb64(mask) + 1;
+		}
+	};
+
+	template <class key_t, size_t bytes>
+	const size_t bucket_index<key_t, bytes>::BITS;
+	template <class key_t, size_t bytes>
+	const size_t bucket_index<key_t, bytes>::BUCKETS;
+	template <class key_t>
+	const size_t bucket_index<key_t, 8>::BITS;
+	template <class key_t>
+	const size_t bucket_index<key_t, 8>::BUCKETS;
+}
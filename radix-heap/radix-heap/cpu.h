@@ -0,0 +1,123 @@
+#pragma once
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+/**
+ * Czy zakada, e procesor obsuguje LZCNT (ABM)?
+ * Jeli 0, instrukcja (LZCNT albo BSR) jest wybierana w runtime na podstawie CPUID, wic jedna binarka
+ * dziaa poprawnie (i moliwie szybko) na kadej maszynie
+ * Jeli 1, sprawdzenie jest pomijane, a na CPU bez ABM wystpi undefined behaviour
+ */
+#ifndef USE_ABM_LZCNT
+#define USE_ABM_LZCNT 0
+#endif
+
+#if (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))) || \
+	((defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)))
+#define RADIX_X86 1
+#else
+#define RADIX_X86 0
+#endif
+
+// Funkcje z kodem SIMD kompilowane dla konkretnego zestawu instrukcji, wywoywane po sprawdzeniu CPU
+#if RADIX_X86 && !defined(_MSC_VER)
+#define RADIX_TARGET(isa) __attribute__((target(isa)))
+#else
+#define RADIX_TARGET(isa)
+#endif
+
+namespace radix {
+	namespace cpu {
+		/**
+		 * CPUID dla licia/podlicia
+		 * Zwraca false jeli procesor nie obsuguje danego licia
+		 */
+		inline bool cpuid(const unsigned leaf, const unsigned subleaf, unsigned regs[4]) {
+#if RADIX_X86 && defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, static_cast<int>(leaf & 0x80000000u));
+			if (static_cast<unsigned>(info[0]) < leaf) return false;
+			__cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+			for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(info[i]);
+			return true;
+#elif RADIX_X86
+			return __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]) != 0;
+#else
+			(void)leaf; (void)subleaf; (void)regs;
+			return false;
+#endif
+		}
+
+		/**
+		 * Czy system zapisuje dane rejestry przy przeczaniu kontekstu (warunek konieczny dla AVX/AVX-512)
+		 * @param mask bity XCR0: 0x6 - XMM/YMM, 0xE6 - dodatkowo ZMM i rejestry masek
+		 */
+		inline bool os_saves_state(const unsigned mask) {
+			unsigned regs[4];
+			if (!cpuid(1, 0, regs) || !(regs[2] & (1u << 27))) return false;
+#if RADIX_X86 && defined(_MSC_VER)
+			return (_xgetbv(0) & mask) == mask;
+#elif RADIX_X86
+			unsigned eax, edx;
+			__asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (eax & mask) == mask;
+#else
+			(void)mask;
+			return false;
+#endif
+		}
+
+		/**
+		 * Sprawdzenie (przez CPUID) czy procesor obsuguje LZCNT
+		 * Bit 5 ECX dla licia 0x80000001 (ABM na AMD, LZCNT na Intelu)
+		 */
+		inline bool detect_lzcnt() {
+#if USE_ABM_LZCNT
+			return true;
+#else
+			unsigned regs[4];
+			return cpuid(0x80000001u, 0, regs) && (regs[2] & (1u << 5));
+#endif
+		}
+
+		// SSE4.1 - bit 19 ECX dla licia 1
+		inline bool detect_sse41() {
+			unsigned regs[4];
+			return cpuid(1, 0, regs) && (regs[2] & (1u << 19));
+		}
+
+		// AVX2 - bit 5 EBX dla licia 7
+		inline bool detect_avx2() {
+			unsigned regs[4];
+			return os_saves_state(0x6) && cpuid(7, 0, regs) && (regs[1] & (1u << 5));
+		}
+
+		// AVX-512F - bit 16 EBX dla licia 7
+		inline bool detect_avx512() {
+			unsigned regs[4];
+			return os_saves_state(0xE6) && cpuid(7, 0, regs) && (regs[1] & (1u << 16));
+		}
+
+		// Wyniki sprawdzenia s liczone raz, przy starcie programu (szablon, eby nagwek mg by wszdzie includowany)
+		template <class = void>
+		struct features {
+			static const bool lzcnt;
+			static const bool sse41;
+			static const bool avx2;
+			static const bool avx512;
+		};
+
+		template <class T>
+		const bool features<T>::lzcnt = detect_lzcnt();
+		template <class T>
+		const bool features<T>::sse41 = detect_sse41();
+		template <class T>
+		const bool features<T>::avx2 = detect_avx2();
+		template <class T>
+		const bool features<T>::avx512 = detect_avx512();
+	}
+}
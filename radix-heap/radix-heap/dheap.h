@@ -1,13 +1,29 @@
 #pragma once
 #include <utility>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include "simd.h"
 
 typedef unsigned uint_t;
 
 /**
-	* Klasa abstrakcyjna reprezentujca kopiec a-arny
+	* Kopiec d-arny z lookup table pozycji (zmiana priorytetu w O(log_D(n)))
+	* - push() dopisuje element na koniec i przesuwa go w gr
+	* - pop() metod Floyda: dziura z korzenia schodzi do licia po najmniejszych dzieciach (bez porwna
+	*   z przenoszonym elementem), ostatni element wstawiany jest w dziur i przesuwany w gr
+	* - przesuwanie w gr/w d jest iteracyjne, z "dziur" zamiast zamian (jeden zapis na poziom)
+	* - tablica elementw jest przesunita tak, e dzieci wza (D kolejnych elementw) zaczynaj si na granicy
+	*   D * sizeof(element) bajtw, a sama tablica jest wyrwnana do linii cache - dla D = 2/4/8 wszystkie dzieci
+	*   wza s w jednej linii cache
+	* Wartoci to liczby cakowite < size (indeks tablicy pozycji), klucze mog si zmienia w obie strony
+	* allocator_t - alokator tablic elementw i pozycji (np. radix::huge_page_allocator), przepinany na waciwe typy
 	*/
-template <uint_t D = 2>
+template <uint_t D = 2, class allocator_t = std::allocator<char>>
 class dheap {
+	static_assert(D >= 2, "Heap arity must be at least 2");
 public:
 	// Struktura przechowujca element kolejki
 	struct element {
@@ -19,100 +35,400 @@ public:
 		uint_t key;
 	};
 
-	explicit dheap(const uint_t size) : _size(size), _count(size) {
-		_elements = new element[_size];
-		_positions = new size_t[_size];
+	/**
+	 * @param size maksymalna ilo elementw (wartoci 0..size-1)
+	 * @param alloc alokator tablic
+	 */
+	explicit dheap(const uint_t size, const allocator_t& alloc = allocator_t())
+		: _element_alloc(alloc), _position_alloc(alloc), _size(size), _count(0) {
+		_storage = element_traits::allocate(_element_alloc, _storage_size());
+		// Element #1 (pierwsze dziecko korzenia) na granicy linii cache
+		const std::uintptr_t line = static_cast<std::uintptr_t>(CACHE_LINE);
+		const std::uintptr_t first = (reinterpret_cast<std::uintptr_t>(_storage + D) + line - 1) / line * line;
+		_elements = reinterpret_cast<element*>(first) - 1;
+		_positions = position_traits::allocate(_position_alloc, _size);
+		std::fill(_positions, _positions + _size, NOT_IN_HEAP);
 	}
 
+	dheap(const dheap&) = delete;
+	dheap& operator=(const dheap&) = delete;
+
 	~dheap() {
-		delete[] _elements;
-		delete[] _positions;
+		element_traits::deallocate(_element_alloc, _storage, _storage_size());
+		position_traits::deallocate(_position_alloc, _positions, _size);
 	}
 
+	/**
+	 * Wstawianie nowej wartoci do kopca
+	 *
+	 * @param value warto do wstawienia (< size, nie moe ju by w kopcu)
+	 * @param key priorytet elementu
+	 */
 	void push(const uint_t value, const uint_t key) {
-		_elements[value] = element(value, key);
-		_positions[value] = value;
+		assert(value < _size && !in_heap(value) && _count < _size);
+		const uint_t i = _count++;
+		_place(i, element(value, key));
+		move_up(i);
 	}
 
+	// Budowa kopca metod Floyda (O(n)) - push() utrzymuje wasno kopca na bieco, zostawione dla zgodnoci API
 	void build_heap() {
-		for (int i = _size / D; i >= 0; --i) move_down(i);
+		if (_count < 2) return;
+		for (uint_t i = (_count - 2) / D + 1; i-- > 0;) move_down(i);
 	}
 
 	const element& front() const {
-		if (_elements[0].key == 0u) return _elements[pos(0)];
+		assert(_count > 0);
 		return _elements[0];
 	}
 
-	uint_t get_key(const uint_t value) {
+	uint_t get_key(const uint_t value) const {
 		return _elements[pos(value)].key;
 	}
 
+	/**
+	 * Zmiana priorytetu elementu bdcego w kopcu (w obie strony)
+	 *
+	 * @param value warto dla ktrej ma by zmieniony priorytet
+	 * @param new_prio nowy priorytet
+	 */
 	void change_priority(const uint_t value, const uint_t new_prio) {
-		const auto position = pos(value);
-		const auto old_key = _elements[position].key;
+		assert(in_heap(value));
+		const uint_t position = pos(value);
+		const uint_t old_key = _elements[position].key;
 		_elements[position].key = new_prio;
-		fix_heap(value);
+		if (new_prio < old_key) move_up(position);
+		else move_down(position);
 	}
 
-	const element& pop() {
-		auto res = _elements[0];
-		swap(0, --_count);
-		_positions[res.value] = INT_MAX ;
-		move_down(0);
+	// Zmniejszenie priorytetu - tylko przesuwanie w gr (API jak RadixHeap)
+	void reduce_priority(const uint_t value, const uint_t new_prio) {
+		assert(in_heap(value) && new_prio <= get_key(value));
+		const uint_t position = pos(value);
+		_elements[position].key = new_prio;
+		move_up(position);
+	}
 
+	/**
+	 * Usuwanie minimum z kopca
+	 * Zwraca (przez warto) najmniejszy element
+	 */
+	element pop() {
+		assert(_count > 0);
+		const element res = _elements[0];
+		_positions[res.value] = NOT_IN_HEAP;
+		if (--_count) {
+			uint_t hole = 0;
+			for (uint_t child; (child = hole * D + 1) < _count;) {
+				const uint_t best = _min_child(child);
+				_place(hole, _elements[best]);
+				hole = best;
+			}
+			_place(hole, _elements[_count]);
+			move_up(hole);
+		}
 		return res;
 	}
 
 	void fix_heap(const uint_t value) {
+		move_up(pos(value));
 		move_down(pos(value));
 	}
 
-	bool in_heap(const uint_t& value) const {
-		return _positions[value] != INT_MAX ;
+	bool in_heap(const uint_t value) const {
+		return _positions[value] != NOT_IN_HEAP;
 	}
 
-protected:
-	uint_t get_parent(const uint_t id) const {
-		if (id == 0) return 0;
-		return (id - 1) / D;
+	uint_t size() const {
+		return _count;
 	}
 
-	bool cmp(const element& a, const element& b) {
-		return a.key <= b.key;
+	bool empty() const {
+		return _count == 0;
 	}
 
-	uint_t& pos(const uint_t value) const {
+protected:
+	typedef typename std::allocator_traits<allocator_t>::template rebind_alloc<element> element_alloc_t;
+	typedef typename std::allocator_traits<allocator_t>::template rebind_alloc<uint_t> position_alloc_t;
+	typedef std::allocator_traits<element_alloc_t> element_traits;
+	typedef std::allocator_traits<position_alloc_t> position_traits;
+
+	// Pozycja wartoci, ktrej nie ma w kopcu
+	static const uint_t NOT_IN_HEAP = std::numeric_limits<uint_t>::max();
+	static const size_t CACHE_LINE = 64;
+
+	// Elementy + zapas na przesunicie do granicy linii cache
+	size_t _storage_size() const {
+		return _size + D + CACHE_LINE / sizeof(element);
+	}
+
+	uint_t pos(const uint_t value) const {
+		assert(in_heap(value));
 		return _positions[value];
 	}
 
-	void swap(const uint_t i, const uint_t largest) {
-		std::swap(_elements[i], _elements[largest]);
-		std::swap(pos(_elements[i].value), pos(_elements[largest].value));
+	// Zapis elementu na pozycji i (z aktualizacj pozycji)
+	void _place(const uint_t i, const element& el) {
+		_elements[i] = el;
+		_positions[el.value] = i;
 	}
 
-	void move_down(const uint_t i) {
-		const auto left = i * D + 1, right = left + D;
-		auto extremum = i;
+	// Najmniejsze dziecko z grupy zaczynajcej si od first - pena grupa ma sta ilo iteracji (rozwijana ptla)
+	uint_t _min_child(const uint_t first) const {
+		uint_t best = first;
+		if (first + D <= _count) {
+			for (uint_t j = 1; j < D; ++j)
+				if (_elements[first + j].key < _elements[best].key) best = first + j;
+		} else {
+			for (uint_t j = first + 1; j < _count; ++j)
+				if (_elements[j].key < _elements[best].key) best = j;
+		}
+		return best;
+	}
 
-		const auto limit = right < _count ? right : _count;
-		// Szukanie najwikszego/najmniejszego dziecka
-		for (auto j = left; j < limit; ++j) {
-			if (cmp(_elements[j], _elements[extremum])) {
-				extremum = j;
-			}
+	// Przesuwanie elementu w gr (np. po zmniejszeniu klucza)
+	void move_up(uint_t i) {
+		const element el = _elements[i];
+		while (i) {
+			const uint_t parent = (i - 1) / D;
+			if (!(el.key < _elements[parent].key)) break;
+			_place(i, _elements[parent]);
+			i = parent;
 		}
+		_place(i, el);
+	}
 
-		if (extremum ^ i) {
-			swap(i, extremum);
-			move_down(extremum);
+	// Przesuwanie elementu w d (np. po zwikszeniu klucza)
+	void move_down(uint_t i) {
+		const element el = _elements[i];
+		for (uint_t child; (child = i * D + 1) < _count;) {
+			const uint_t best = _min_child(child);
+			if (!(_elements[best].key < el.key)) break;
+			_place(i, _elements[best]);
+			i = best;
 		}
+		_place(i, el);
 	}
 
-	// Elementy
+	element_alloc_t _element_alloc;
+	position_alloc_t _position_alloc;
+	// Zaalokowany blok elementw
+	element* _storage;
+	// Elementy (wewntrz _storage, z przesuniciem)
 	element* _elements;
 	// Pozycje elementw
 	uint_t* _positions;
+	// Maksymalna ilo elementw
+	const uint_t _size;
 	// Ilo elementw w kolejce
+	uint_t _count;
+};
+
+template <uint_t D, class allocator_t>
+const uint_t dheap<D, allocator_t>::NOT_IN_HEAP;
+template <uint_t D, class allocator_t>
+const size_t dheap<D, allocator_t>::CACHE_LINE;
+
+/**
+	* Kopiec d-arny dla szerokich wzw (D = 8/16) - klucze i wartoci w osobnych tablicach (SoA)
+	* - dzieci wza to 8/16 kolejnych kluczy (32/64 bajty) wyrwnanych do swojej wielkoci, wic najmniejsze
+	*   dziecko wybierane jest kilkoma instrukcjami (radix::simd::min_index - AVX2/AVX-512, wersja skalarna bez nich)
+	* - klucze za ostatnim elementem maj maksymaln warto, wic kada grupa dzieci jest pena
+	*   (remis rozstrzygany jest na korzy niszego indeksu - prawdziwego elementu)
+	* Pytszy kopiec (log_16(n) poziomw) kosztem wikszej iloci porwna na poziom; API jak dheap
+	*/
+template <uint_t D, class allocator_t = std::allocator<char>>
+class wide_dheap {
+	static_assert(sizeof(uint_t) == sizeof(std::uint32_t), "Keys must be 32-bit");
+public:
+	struct element {
+		element() : value(0), key(0) {}
+
+		element(const uint_t value, const uint_t key) : value(value), key(key) {}
+
+		uint_t value;
+		uint_t key;
+	};
+
+	explicit wide_dheap(const uint_t size, const allocator_t& alloc = allocator_t())
+		: _alloc(alloc), _size(size), _count(0) {
+		_key_storage = traits::allocate(_alloc, _storage_size());
+		std::fill(_key_storage, _key_storage + _storage_size(), NO_KEY);
+		// Pierwsze dziecko korzenia (klucz #1) na granicy linii cache - grupa dzieci wza i zaczyna si od D * (i + 1)
+		const std::uintptr_t line = static_cast<std::uintptr_t>(CACHE_LINE);
+		const std::uintptr_t first = (reinterpret_cast<std::uintptr_t>(_key_storage + D) + line - 1) / line * line;
+		_keys = reinterpret_cast<uint_t*>(first) - 1;
+		_values = traits::allocate(_alloc, _size);
+		_positions = traits::allocate(_alloc, _size);
+		std::fill(_positions, _positions + _size, NOT_IN_HEAP);
+	}
+
+	wide_dheap(const wide_dheap&) = delete;
+	wide_dheap& operator=(const wide_dheap&) = delete;
+
+	~wide_dheap() {
+		traits::deallocate(_alloc, _key_storage, _storage_size());
+		traits::deallocate(_alloc, _values, _size);
+		traits::deallocate(_alloc, _positions, _size);
+	}
+
+	void push(const uint_t value, const uint_t key) {
+		assert(value < _size && !in_heap(value) && _count < _size);
+		const uint_t i = _count++;
+		_place(i, value, key);
+		move_up(i);
+	}
+
+	// Budowa kopca metod Floyda (O(n)) - push() utrzymuje wasno kopca na bieco, zostawione dla zgodnoci API
+	void build_heap() {
+		if (_count < 2) return;
+		for (uint_t i = (_count - 2) / D + 1; i-- > 0;) move_down(i);
+	}
+
+	element front() const {
+		assert(_count > 0);
+		return element(_values[0], _keys[0]);
+	}
+
+	uint_t get_key(const uint_t value) const {
+		return _keys[pos(value)];
+	}
+
+	void change_priority(const uint_t value, const uint_t new_prio) {
+		const uint_t position = pos(value);
+		const uint_t old_key = _keys[position];
+		_keys[position] = new_prio;
+		if (new_prio < old_key) move_up(position);
+		else move_down(position);
+	}
+
+	void reduce_priority(const uint_t value, const uint_t new_prio) {
+		assert(new_prio <= get_key(value));
+		const uint_t position = pos(value);
+		_keys[position] = new_prio;
+		move_up(position);
+	}
+
+	/**
+	 * Usuwanie minimum z kopca (metod Floyda jak w dheap)
+	 * Zwalniane miejsce ostatniego elementu dostaje klucz NO_KEY przed zejciem dziury
+	 */
+	element pop() {
+		assert(_count > 0);
+		const element res(_values[0], _keys[0]);
+		_positions[res.value] = NOT_IN_HEAP;
+		const uint_t last_value = _values[--_count], last_key = _keys[_count];
+		_keys[_count] = NO_KEY;
+		if (_count) {
+			uint_t hole = 0;
+			for (uint_t child; (child = hole * D + 1) < _count;) {
+				const uint_t best = _min_child(child);
+				_place(hole, _values[best], _keys[best]);
+				hole = best;
+			}
+			_place(hole, last_value, last_key);
+			move_up(hole);
+		}
+		return res;
+	}
+
+	void fix_heap(const uint_t value) {
+		move_up(pos(value));
+		move_down(pos(value));
+	}
+
+	bool in_heap(const uint_t value) const {
+		return _positions[value] != NOT_IN_HEAP;
+	}
+
+	uint_t size() const {
+		return _count;
+	}
+
+	bool empty() const {
+		return _count == 0;
+	}
+
+protected:
+	typedef typename std::allocator_traits<allocator_t>::template rebind_alloc<uint_t> alloc_t;
+	typedef std::allocator_traits<alloc_t> traits;
+
+	static const uint_t NOT_IN_HEAP = std::numeric_limits<uint_t>::max();
+	// Klucz miejsc za ostatnim elementem
+	static const uint_t NO_KEY = std::numeric_limits<uint_t>::max();
+	static const size_t CACHE_LINE = 64;
+
+	// Klucze + dopenienie ostatniej grupy dzieci + zapas na wyrwnanie
+	size_t _storage_size() const {
+		return _size + 2 * D + CACHE_LINE / sizeof(uint_t);
+	}
+
+	uint_t pos(const uint_t value) const {
+		assert(in_heap(value));
+		return _positions[value];
+	}
+
+	void _place(const uint_t i, const uint_t value, const uint_t key) {
+		_keys[i] = key;
+		_values[i] = value;
+		_positions[value] = i;
+	}
+
+	uint_t _min_child(const uint_t first) const {
+		return first + radix::simd::min_index<D>(_keys + first);
+	}
+
+	void move_up(uint_t i) {
+		const uint_t value = _values[i], key = _keys[i];
+		while (i) {
+			const uint_t parent = (i - 1) / D;
+			if (!(key < _keys[parent])) break;
+			_place(i, _values[parent], _keys[parent]);
+			i = parent;
+		}
+		_place(i, value, key);
+	}
+
+	void move_down(uint_t i) {
+		const uint_t value = _values[i], key = _keys[i];
+		for (uint_t child; (child = i * D + 1) < _count;) {
+			const uint_t best = _min_child(child);
+			if (!(_keys[best] < key)) break;
+			_place(i, _values[best], _keys[best]);
+			i = best;
+		}
+		_place(i, value, key);
+	}
+
+	alloc_t _alloc;
+	// Zaalokowany blok kluczy
+	uint_t* _key_storage;
+	// Klucze (wewntrz _key_storage, z przesuniciem), wartoci i pozycje wartoci
+	uint_t* _keys;
+	uint_t* _values;
+	uint_t* _positions;
+	// Maksymalna ilo elementw
 	const uint_t _size;
+	// Ilo elementw w kolejce
 	uint_t _count;
-};
\ No newline at end of file
+};
+
+template <uint_t D, class allocator_t>
+const uint_t wide_dheap<D, allocator_t>::NOT_IN_HEAP;
+template <uint_t D, class allocator_t>
+const uint_t wide_dheap<D, allocator_t>::NO_KEY;
+template <uint_t D, class allocator_t>
+const size_t wide_dheap<D, allocator_t>::CACHE_LINE;
+
+// dheap<8> i dheap<16> - wersja z wektorowym wyborem dziecka
+template <class allocator_t>
+class dheap<8, allocator_t> : public wide_dheap<8, allocator_t> {
+public:
+	using wide_dheap<8, allocator_t>::wide_dheap;
+};
+
+template <class allocator_t>
+class dheap<16, allocator_t> : public wide_dheap<16, allocator_t> {
+public:
+	using wide_dheap<16, allocator_t>::wide_dheap;
+};
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "vector.h"
+#include "arena.h"
+#include "bucket_index.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace radix {
+	/**
+	 * Kolejka Diala - cykliczna tablica kubekw, po jednym na kady klucz z zakresu
+	 * [ostatnio usunity, ostatnio usunity + range)
+	 * Przy maej maksymalnej wadze krawdzi C (np. ilo przeskokw, odlegoci zaokrglone do 10m)
+	 * push/pop/reduce_priority s O(1) - bez redystrybucji, ktre RadixHeap wykonuje O(log C) razy
+	 * - ilo kubekw to potga dwjki >= range, kubeek klucza to key & (ilo - 1), wic wszystkie
+	 *   elementy kubeka maj ten sam klucz
+	 * - pop() szuka nastpnego niepustego kubeka w masce zajtoci (64 kubeki na sowo)
+	 * - klucz spoza zakresu powiksza tablic (kubeki s przenoszone w caoci, bez ruszania elementw)
+	 * API jak RadixHeap z lookup table (push/pop/top/reduce_priority/in_heap/reset), wic kolejka
+	 * dziaa bezporednio z graph::dijkstra
+	 *
+	 * Wymagania:
+	 *	- klucz jest liczb cakowit bez znaku
+	 *	- elementy wrzucane s nie mniejsze ni ostatni usunity element
+	 *	- wartoci s unikalnymi liczbami cakowitymi < element_count (indeks lookup table)
+	 */
+	template <class value_t = unsigned, class key_t = unsigned, class allocator_t = malloc_allocator<char>>
+	class dial_queue {
+		static_assert(std::is_integral<key_t>::value && std::is_unsigned<key_t>::value,
+			"Key must be unsigned integer type");
+
+		template <class T>
+		using _rebind_t = typename std::allocator_traits<allocator_t>::template rebind_alloc<T>;
+	public:
+		// Struktura przechowujca element kolejki
+		struct element {
+			element() : value(value_t()), key(0) {}
+
+			element(const value_t& value, const key_t key) : value(value), key(key) {}
+
+			value_t value;
+			key_t key;
+		};
+
+		typedef vector<element, false, _rebind_t<element>> bucket_t;
+		typedef allocator_t allocator_type;
+
+		/**
+		 * Konstruktor
+		 * @param element_count maksymalna ilo elementw (wielko lookup table)
+		 * @param range pocztkowy zakres kluczy w kolejce, np. maksymalna waga krawdzi + 1
+		 * @param alloc alokator dla kubekw i lookup table
+		 */
+		explicit dial_queue(const size_t element_count, const size_t range = DEFAULT_RANGE, const allocator_t& alloc = allocator_t())
+			: _buckets(_ring_size(range), bucket_t(alloc), alloc), _occupied(_words(_buckets.size()), 0, alloc),
+			_lookup_alloc(alloc), _element_count(element_count) {
+			_mask = _buckets.size() - 1;
+			if (_element_count) _lookup = _allocate_lookup(detail::has_allocate_zeroed<_lookup_alloc_t>());
+		}
+
+		dial_queue(const dial_queue&) = delete;
+		dial_queue& operator=(const dial_queue&) = delete;
+
+		~dial_queue() {
+			if (_lookup) std::allocator_traits<_lookup_alloc_t>::deallocate(_lookup_alloc, _lookup, _element_count);
+		}
+
+		/**
+		 * Usuwanie minimum z kolejki
+		 * Zwraca (przez warto) najmniejszy element w kolejce
+		 */
+		element pop() {
+			const size_t slot = _pull_least();
+			--_items_count;
+			element least = _buckets[slot].pop_back();
+			if (_buckets[slot].empty()) _clear_occupied(slot);
+			_lookup[least.value] = lookup_entry();
+			return least;
+		}
+
+		/**
+		 * Podgld najmniejszego elementu bez usuwania go z kolejki
+		 * Referencja jest wana do nastpnej operacji modyfikujcej kolejk
+		 */
+		const element& top() {
+			return _buckets[_pull_least()].back();
+		}
+
+		/**
+		 * Wstawianie nowej wartoci do kolejki
+		 *
+		 * @param item warto do wstawienia
+		 * @param key priorytet elementu do wstawienia
+		 */
+		void push(const value_t& item, const key_t key) {
+			assert(key >= _last_deleted);
+			assert(static_cast<size_t>(item) < _element_count && !in_heap(item));
+			if (static_cast<size_t>(key - _last_deleted) > _mask) _grow(static_cast<size_t>(key - _last_deleted) + 1);
+			++_items_count;
+			_place(element(item, key));
+		}
+
+		/**
+		 * Zmiana priorytetu elementu bdcego ju w kolejce - przeniesienie midzy kubekami w O(1)
+		 *
+		 * @param item warto dla ktrej ma by zmieniony priorytet
+		 * @param new_key nowy priorytet dla elementu (nie wikszy ni stary, nie mniejszy ni ostatnio usunity)
+		 */
+		void reduce_priority(const value_t& item, const key_t new_key) {
+			lookup_entry& entry = _lookup[item];
+			assert(entry.position != NON_EXISTING_POS);
+			assert(new_key <= entry.key && new_key >= _last_deleted);
+			if (new_key == entry.key) return;
+
+			// Usunicie ze rodka kubeka - ostatni element przenoszony jest na zwolnione miejsce
+			const size_t slot = _slot(entry.key), item_pos = entry.position - 1;
+			bucket_t& bucket = _buckets[slot];
+			const element last = bucket.pop_back();
+			if (item_pos != bucket.size()) {
+				bucket[item_pos] = last;
+				_lookup[last.value].position = _position(item_pos);
+			}
+			if (bucket.empty()) _clear_occupied(slot);
+
+			_place(element(item, new_key));
+		}
+
+		// Ilo elementw w kolejce
+		size_t size() const {
+			return _items_count;
+		}
+
+		// Czy kolejka jest pusta?
+		bool empty() const {
+			return _items_count == 0;
+		}
+
+		// Sprawdzenie czy element jest w kolejce
+		bool in_heap(const value_t& value) const {
+			return _lookup[value].position != NON_EXISTING_POS;
+		}
+
+		/**
+		 * Oprnienie kolejki do ponownego uycia - czyszczone s tylko niepuste kubeki (wg maski)
+		 * i wpisy lookup table ich elementw, kubeki zachowuj zaalokowan pami
+		 */
+		void reset() {
+			for (size_t w = 0; w < _occupied.size(); ++w) {
+				for (std::uint64_t bits = _occupied[w]; bits; bits &= bits - 1) {
+					bucket_t& bucket = _buckets[w * 64 + detail::lsb64(bits)];
+					for (const element& el : bucket) _lookup[el.value] = lookup_entry();
+					bucket.clear();
+				}
+				_occupied[w] = 0;
+			}
+			_items_count = 0;
+			_last_deleted = 0;
+		}
+
+	private:
+		// Rekord lookup table - pozycja w kubeku (+1, rekord z samych zer oznacza brak w kolejce) i priorytet
+		struct lookup_entry {
+			std::uint32_t position;
+			key_t key;
+		};
+
+		typedef _rebind_t<lookup_entry> _lookup_alloc_t;
+
+		size_t _slot(const key_t key) const {
+			return static_cast<size_t>(key) & _mask;
+		}
+
+		// Wstawienie elementu do kubeka jego klucza (bez zmiany iloci elementw)
+		void _place(const element& el) {
+			const size_t slot = _slot(el.key);
+			bucket_t& bucket = _buckets[slot];
+			bucket.push_back(el);
+			_occupied[slot / 64] |= static_cast<std::uint64_t>(1) << (slot % 64);
+			lookup_entry& entry = _lookup[el.value];
+			entry.position = _position(bucket.size() - 1);
+			entry.key = el.key;
+		}
+
+		void _clear_occupied(const size_t slot) {
+			_occupied[slot / 64] &= ~(static_cast<std::uint64_t>(1) << (slot % 64));
+		}
+
+		/**
+		 * Przesunicie ostatnio usunitej wartoci na najmniejszy klucz w kolejce
+		 * Nastpny niepusty kubeek (cyklicznie od kubeka _last_deleted) - najniszy bit maski zajtoci
+		 * Zwraca numer kubeka z elementami minimalnymi
+		 */
+		size_t _pull_least() {
+			assert(_items_count > 0);
+			const size_t start = _slot(_last_deleted), words = _occupied.size();
+			size_t w = start / 64;
+			std::uint64_t bits = _occupied[w] & (~static_cast<std::uint64_t>(0) << (start % 64));
+			// Najwyej jedno pene okrenie - niej od start w sowie pocztkowym po zawiniciu
+			for (size_t i = 0; !bits; ++i) {
+				assert(i <= words);
+				w = (w + 1) % words;
+				bits = _occupied[w];
+			}
+			const size_t slot = w * 64 + detail::lsb64(bits);
+			_last_deleted += static_cast<key_t>((slot - start) & _mask);
+			return slot;
+		}
+
+		/**
+		 * Powikszenie tablicy kubekw tak, eby miecia zakres range
+		 * Kady kubeek zawiera elementy o jednym kluczu, wic jest przenoszony w caoci (pozycje si nie zmieniaj)
+		 */
+		void _grow(const size_t range) {
+			const size_t size = std::max(_ring_size(range), _buckets.size() * 2);
+			std::vector<bucket_t, _rebind_t<bucket_t>> buckets(size, bucket_t(_buckets.get_allocator()), _buckets.get_allocator());
+			std::vector<std::uint64_t, _rebind_t<std::uint64_t>> occupied(_words(size), 0, _occupied.get_allocator());
+			for (size_t w = 0; w < _occupied.size(); ++w) {
+				for (std::uint64_t bits = _occupied[w]; bits; bits &= bits - 1) {
+					bucket_t& bucket = _buckets[w * 64 + detail::lsb64(bits)];
+					const size_t slot = static_cast<size_t>(bucket[0].key) & (size - 1);
+					buckets[slot].swap(bucket);
+					occupied[slot / 64] |= static_cast<std::uint64_t>(1) << (slot % 64);
+				}
+			}
+			_buckets.swap(buckets);
+			_occupied.swap(occupied);
+			_mask = size - 1;
+		}
+
+		// Ilo kubekw - potga dwjki, co najmniej jedno sowo maski
+		static size_t _ring_size(const size_t range) {
+			size_t res = 64;
+			while (res < range) res *= 2;
+			return res;
+		}
+
+		static size_t _words(const size_t buckets) {
+			return buckets / 64;
+		}
+
+		static std::uint32_t _position(const size_t pos) {
+			assert(pos < std::numeric_limits<std::uint32_t>::max());
+			return static_cast<std::uint32_t>(pos + 1);
+		}
+
+		// Wyzerowana lookup table - jak w RadixHeap (calloc()/mmap, inne alokatory - memset())
+		lookup_entry* _allocate_lookup(std::true_type) {
+			return _lookup_alloc.allocate_zeroed(_element_count);
+		}
+
+		lookup_entry* _allocate_lookup(std::false_type) {
+			lookup_entry *res = std::allocator_traits<_lookup_alloc_t>::allocate(_lookup_alloc, _element_count);
+			std::memset(res, 0, _element_count * sizeof(lookup_entry));
+			return res;
+		}
+
+		// Domylny zakres kluczy (tablica ronie, jeli jest za may)
+		static const size_t DEFAULT_RANGE = 1024;
+		// Zakodowana pozycja oznaczajca brak w kolejce
+		static const std::uint32_t NON_EXISTING_POS = 0;
+
+		// Ostatnio usunita warto - kubeek, od ktrego zaczyna si szukanie minimum
+		key_t _last_deleted = 0;
+		// Ilo elementw w kolejce
+		size_t _items_count = 0;
+		// Cykliczna tablica kubekw i maska zajtoci (bit na kubeek)
+		std::vector<bucket_t, _rebind_t<bucket_t>> _buckets;
+		std::vector<std::uint64_t, _rebind_t<std::uint64_t>> _occupied;
+		// Ilo kubekw - 1
+		size_t _mask;
+
+		_lookup_alloc_t _lookup_alloc;
+		// Lookup table - pozycje i priorytety wartoci
+		lookup_entry* _lookup = nullptr;
+		size_t _element_count;
+	};
+
+	template <class value_t, class key_t, class allocator_t>
+	const size_t dial_queue<value_t, key_t, allocator_t>::DEFAULT_RANGE;
+	template <class value_t, class key_t, class allocator_t>
+	const std::uint32_t dial_queue<value_t, key_t, allocator_t>::NON_EXISTING_POS;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "radix.h"
+#include "radix_oop.h"
+#include "dheap.h"
+#include "dial.h"
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+	/**
+	 * Graf skierowany w formacie CSR (compressed sparse row)
+	 * Krawdzie wychodzce z wierzchoka v to [offsets[v], offsets[v + 1]) w tablicach targets/weights
+	 *
+	 * Wymagania:
+	 *	- wagi s nieujemne
+	 *	- suma wag na najkrtszej ciece mieci si w weight_t (bez UNREACHABLE)
+	 */
+	template <class weight_t = unsigned, class vertex_t = unsigned>
+	class csr_graph {
+	public:
+		// Krawd wejciowa dla from_edges()
+		struct edge {
+			vertex_t from;
+			vertex_t to;
+			weight_t weight;
+		};
+
+		csr_graph() {
+			_offsets.push_back(0);
+		}
+
+		/**
+		 * Konstruktor z gotowych tablic CSR
+		 * @param offsets tablica n + 1 przesuni
+		 * @param targets wierzchoki docelowe krawdzi
+		 * @param weights wagi krawdzi
+		 */
+		csr_graph(std::vector<size_t> offsets, std::vector<vertex_t> targets, std::vector<weight_t> weights)
+			: _offsets(std::move(offsets)), _targets(std::move(targets)), _weights(std::move(weights)) {}
+
+		/**
+		 * Budowanie grafu z listy krawdzi (sortowanie przez zliczanie po wierzchoku rdowym)
+		 * @param vertices ilo wierzchokw
+		 * @param edges lista krawdzi
+		 */
+		static csr_graph from_edges(const size_t vertices, const std::vector<edge>& edges) {
+			std::vector<size_t> offsets(vertices + 1, 0);
+			for (const edge& e : edges) ++offsets[e.from + 1];
+			for (size_t v = 0; v < vertices; ++v) offsets[v + 1] += offsets[v];
+
+			std::vector<vertex_t> targets(edges.size());
+			std::vector<weight_t> weights(edges.size());
+			std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+			for (const edge& e : edges) {
+				const size_t pos = next[e.from]++;
+				targets[pos] = e.to;
+				weights[pos] = e.weight;
+			}
+			return csr_graph(std::move(offsets), std::move(targets), std::move(weights));
+		}
+
+		size_t vertices() const { return _offsets.size() - 1; }
+		size_t edges() const { return _targets.size(); }
+		// Zakres krawdzi wychodzcych z wierzchoka
+		size_t begin(const vertex_t v) const { return _offsets[v]; }
+		size_t end(const vertex_t v) const { return _offsets[v + 1]; }
+		vertex_t target(const size_t e) const { return _targets[e]; }
+		weight_t weight(const size_t e) const { return _weights[e]; }
+
+	private:
+		std::vector<size_t> _offsets;
+		std::vector<vertex_t> _targets;
+		std::vector<weight_t> _weights;
+	};
+
+	/**
+	 * Ujednolicenie API kolejek dla alg. Dijkstry
+	 * Domylnie zakadane jest API RadixHeap: push/pop/reduce_priority/in_heap (RadixHeap, dheap, radix::dial_queue)
+	 * Wierzchoki wrzucane s do kolejki dopiero przy pierwszym osigniciu
+	 */
+	template <class heap_t>
+	struct heap_adapter {
+		static void start(heap_t& heap, const unsigned source) {
+			heap.push(source, 0);
+		}
+
+		template <class weight_t>
+		static void relax(heap_t& heap, const unsigned v, const weight_t key, const bool first_visit) {
+			if (first_visit) heap.push(v, key);
+			else heap.reduce_priority(v, key);
+		}
+
+		template <class weight_t>
+		static std::pair<unsigned, weight_t> pop(heap_t& heap) {
+			const auto el = heap.pop();
+			return std::pair<unsigned, weight_t>(el.value, el.key);
+		}
+	};
+
+	/**
+	 * radix::lookup_queue - elementy to pary (warto, klucz), zmiana priorytetu przez change_priority
+	 */
+	template <class value_t, class key_t, class bucket_t, class lookup_t>
+	struct heap_adapter<radix::lookup_queue<value_t, key_t, bucket_t, lookup_t>> {
+		typedef radix::lookup_queue<value_t, key_t, bucket_t, lookup_t> heap_t;
+
+		static void start(heap_t& heap, const unsigned source) {
+			heap.push(source, 0);
+		}
+
+		template <class weight_t>
+		static void relax(heap_t& heap, const unsigned v, const weight_t key, const bool first_visit) {
+			if (first_visit) heap.push(v, key);
+			else heap.change_priority(v, key);
+		}
+
+		template <class weight_t>
+		static std::pair<unsigned, weight_t> pop(heap_t& heap) {
+			const auto el = heap.pop();
+			return std::pair<unsigned, weight_t>(el.first, el.second);
+		}
+	};
+
+	/**
+	 * Najkrtsze cieki z jednego rda (alg. Dijkstry)
+	 * Z RadixHeap zoono ~O(m + n*logC), z dheap<D> O(m*log_D(n)), z radix::dial_queue O(m + n + D*),
+	 * gdzie D* to dugo najduszej ze znalezionych cieek (opacalna przy maych wagach)
+	 *
+	 * @param g graf
+	 * @param source wierzchoek startowy
+	 * @param dist bufor na n odlegoci, nieosigalne wierzchoki dostaj UNREACHABLE
+	 * @param pred opcjonalny bufor na n poprzednikw (rdo i nieosigalne wskazuj na siebie)
+	 * Zwraca ilo wierzchokw zdjtych z kolejki (bez nieaktualnych duplikatw)
+	 */
+	template <class heap_t, class weight_t, class vertex_t>
+	size_t dijkstra(const csr_graph<weight_t, vertex_t>& g, const vertex_t source, weight_t* dist, vertex_t* pred = nullptr) {
+		heap_t heap(g.vertices());
+		return dijkstra(heap, g, source, dist, pred);
+	}
+
+	/**
+	 * Wersja z kolejk dostarczon przez wywoujcego (pust, na co najmniej n elementw),
+	 * np. tworzon dla kadego zapytania na wsplnej arenie (radix::arena_allocator)
+	 */
+	template <class heap_t, class weight_t, class vertex_t>
+	size_t dijkstra(heap_t& heap, const csr_graph<weight_t, vertex_t>& g, const vertex_t source, weight_t* dist, vertex_t* pred = nullptr) {
+		const weight_t UNREACHABLE = std::numeric_limits<weight_t>::max();
+		const size_t n = g.vertices();
+		for (size_t v = 0; v < n; ++v) dist[v] = UNREACHABLE;
+		if (pred) for (size_t v = 0; v < n; ++v) pred[v] = static_cast<vertex_t>(v);
+
+		typedef heap_adapter<heap_t> adapter;
+		adapter::start(heap, source);
+		dist[source] = 0;
+
+		size_t settled = 0;
+		while (!heap.empty()) {
+			const auto top = adapter::template pop<weight_t>(heap);
+			const vertex_t u = static_cast<vertex_t>(top.first);
+			// Nieaktualny wpis (kolejka z "leniwym" reduce_priority, ktre wstawia duplikat) - wierzchoek ju zdjty
+			if (top.second != dist[u]) continue;
+			++settled;
+
+			for (size_t e = g.begin(u); e < g.end(u); ++e) {
+				const vertex_t v = g.target(e);
+				const weight_t new_dist = top.second + g.weight(e);
+				if (new_dist >= dist[v]) continue;
+
+				adapter::relax(heap, v, new_dist, dist[v] == UNREACHABLE);
+				dist[v] = new_dist;
+				if (pred) pred[v] = u;
+			}
+		}
+
+		return settled;
+	}
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Pami na duych stronach (2MB) z opcjonalnym przypiciem do wza NUMA
+ * Lookup table, pozycje kopca d-arnego i due kubeki s odczytywane losowo (wg numeru wierzchoka),
+ * wic przy duych grafach koszt dominuj chybienia w TLB, a nie w cache danych
+ *
+ * - Linux: mmap() z MAP_HUGETLB (jawne due strony, wymagaj puli vm.nr_hugepages), a jeli jej nie ma -
+ *   zwyke mmap() + madvise(MADV_HUGEPAGE) (transparent huge pages); wze NUMA przez mbind()
+ * - Windows: VirtualAllocExNuma(), MEM_LARGE_PAGES jeli proces ma uprawnienie SeLockMemoryPrivilege
+ * - inne systemy: malloc()
+ * Pami z mmap/VirtualAlloc jest wyzerowana przez system (przy pierwszym dotkniciu strony)
+ */
+namespace radix {
+	namespace memory {
+		// Wielko duej strony (x86-64) - mniejsze bloki nie s mapowane osobno
+		static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+		// Bez przypicia do wza NUMA
+		static const int NO_NUMA_NODE = -1;
+		// Wze NUMA wtku, ktry alokuje pami
+		static const int LOCAL_NUMA_NODE = -2;
+
+		/**
+		 * Licznik nieudanych przypi do wza NUMA (np. jdro bez NUMA, wze spoza maski procesu)
+		 * Blok zostaje zmapowany bez przypicia - jak dla NO_NUMA_NODE, strony trafiaj na wze wtku, ktry pierwszy je dotknie
+		 */
+		inline std::atomic<size_t>& numa_bind_failures() {
+			static std::atomic<size_t> failures(0);
+			return failures;
+		}
+
+		// Wze NUMA procesora, na ktrym dziaa biecy wtek (NO_NUMA_NODE jeli nieznany)
+		inline int current_numa_node() {
+#if defined(_WIN32)
+			PROCESSOR_NUMBER processor;
+			GetCurrentProcessorNumberEx(&processor);
+			USHORT node;
+			return GetNumaProcessorNodeEx(&processor, &node) ? static_cast<int>(node) : NO_NUMA_NODE;
+#elif defined(__linux__) && defined(SYS_getcpu)
+			unsigned cpu, node;
+			return syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ? static_cast<int>(node) : NO_NUMA_NODE;
+#else
+			return NO_NUMA_NODE;
+#endif
+		}
+
+		/**
+		 * Mapowanie wyzerowanej pamici na duych stronach
+		 * @param bytes wielko - wielokrotno HUGE_PAGE_SIZE
+		 * @param numa_node wze NUMA, NO_NUMA_NODE albo LOCAL_NUMA_NODE
+		 * Zwraca nullptr jeli si nie udao (nieudane przypicie do wza nie jest bdem - patrz numa_bind_failures())
+		 */
+		inline void* map_huge(const size_t bytes, int numa_node) {
+			if (numa_node == LOCAL_NUMA_NODE) numa_node = current_numa_node();
+#if defined(_WIN32)
+			const DWORD node = numa_node >= 0 ? static_cast<DWORD>(numa_node) : NUMA_NO_PREFERRED_NODE;
+			const SIZE_T large = GetLargePageMinimum();
+			void *res = nullptr;
+			if (large && bytes % large == 0)
+				res = VirtualAllocExNuma(GetCurrentProcess(), nullptr, bytes,
+					MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+			if (!res) res = VirtualAllocExNuma(GetCurrentProcess(), nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+			return res;
+#elif defined(__linux__)
+			void *res = MAP_FAILED;
+#ifdef MAP_HUGETLB
+			res = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+			if (res == MAP_FAILED) {
+				res = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (res == MAP_FAILED) return nullptr;
+#ifdef MADV_HUGEPAGE
+				madvise(res, bytes, MADV_HUGEPAGE);
+#endif
+			}
+#ifdef SYS_mbind
+			// Przypicie przed pierwszym dotkniciem - strony s alokowane od razu na waciwym wle
+			// (MPOL_PREFERRED = 1 - jeli na wle zabraknie pamici, bierze z innego zamiast bdu)
+			// Bd nie uniewania mapowania - blok zostaje bez przypicia, a poraka trafia do numa_bind_failures()
+			if (numa_node >= 0) {
+				const unsigned long mask = numa_node < static_cast<int>(sizeof(unsigned long) * 8) ? 1ul << numa_node : 0;
+				if (!mask || syscall(SYS_mbind, res, bytes, 1, &mask, sizeof(mask) * 8, 0) != 0) ++numa_bind_failures();
+			}
+#else
+			if (numa_node >= 0) ++numa_bind_failures();
+#endif
+			return res;
+#else
+			(void)numa_node;
+			return std::calloc(1, bytes);
+#endif
+		}
+
+		/**
+		 * Zmiana wielkoci zmapowanego bloku (wielokrotnoci HUGE_PAGE_SIZE)
+		 * Linux - mremap() bez kopiowania (strony i polityka NUMA zostaj), nullptr jeli si nie udao
+		 */
+		inline void* remap_huge(void* p, const size_t old_bytes, const size_t new_bytes) {
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+			void *res = mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+			return res == MAP_FAILED ? nullptr : res;
+#else
+			(void)p; (void)old_bytes; (void)new_bytes;
+			return nullptr;
+#endif
+		}
+
+		inline void unmap_huge(void* p, const size_t bytes) {
+#if defined(_WIN32)
+			(void)bytes;
+			VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__linux__)
+			munmap(p, bytes);
+#else
+			(void)bytes;
+			std::free(p);
+#endif
+		}
+	}
+
+	/**
+	 * Alokator duych blokw na duych stronach - bloki od HUGE_PAGE_SIZE w gr s mapowane osobno
+	 * (zaokrglone do wielokrotnoci duej strony), mniejsze pochodz z malloc()
+	 * Jako allocator_t RadixHeap obejmuje lookup table i kubeki, ktre urosy ponad prg
+	 *
+	 * numa_node - wze NUMA dla blokw mapowanych, domylnie wze wtku alokujcego
+	 * (kolejka tworzona przez wtek roboczy, ktry z niej korzysta)
+	 */
+	template <class T>
+	struct huge_page_allocator {
+		typedef T value_type;
+
+		explicit huge_page_allocator(const int numa_node = memory::LOCAL_NUMA_NODE) : numa_node(numa_node) {}
+		template <class U>
+		huge_page_allocator(const huge_page_allocator<U>& other) : numa_node(other.numa_node) {}
+
+		T* allocate(const size_t n) {
+			return _allocate(n, false);
+		}
+
+		// Wyzerowany blok (mapowane strony s zerowane przez system - bez zapisywania caoci)
+		T* allocate_zeroed(const size_t n) {
+			return _allocate(n, true);
+		}
+
+		/**
+		 * Zmiana wielkoci bloku z zachowaniem zawartoci (tylko dla typw trywialnie kopiowalnych)
+		 * Blok zmapowany ronie przez mremap(), przejcie midzy malloc() a mapowaniem - kopia
+		 */
+		T* reallocate(T* p, const size_t old_n, const size_t new_n) {
+			const size_t old_bytes = old_n * sizeof(T), new_bytes = new_n * sizeof(T);
+			const bool old_mapped = p && old_bytes >= memory::HUGE_PAGE_SIZE;
+			const bool new_mapped = new_bytes >= memory::HUGE_PAGE_SIZE;
+			if (!old_mapped && !new_mapped) {
+				T *res = static_cast<T*>(std::realloc(p, new_bytes));
+				if (!res && new_bytes) throw std::bad_alloc();
+				return res;
+			}
+			if (old_mapped && new_mapped) {
+				if (_round(old_bytes) == _round(new_bytes)) return p;
+				if (void *res = memory::remap_huge(p, _round(old_bytes), _round(new_bytes))) return static_cast<T*>(res);
+			}
+			T *res = _allocate(new_n, false);
+			if (p) std::memcpy(res, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+			deallocate(p, old_n);
+			return res;
+		}
+
+		void deallocate(T* p, const size_t n) {
+			if (!p) return;
+			const size_t bytes = n * sizeof(T);
+			if (bytes >= memory::HUGE_PAGE_SIZE) memory::unmap_huge(p, _round(bytes));
+			else std::free(p);
+		}
+
+		int numa_node;
+	private:
+		static size_t _round(const size_t bytes) {
+			return (bytes + memory::HUGE_PAGE_SIZE - 1) / memory::HUGE_PAGE_SIZE * memory::HUGE_PAGE_SIZE;
+		}
+
+		T* _allocate(const size_t n, const bool zeroed) {
+			const size_t bytes = n * sizeof(T);
+			void *res = bytes >= memory::HUGE_PAGE_SIZE ? memory::map_huge(_round(bytes), numa_node)
+				: zeroed ? std::calloc(n, sizeof(T)) : std::malloc(bytes);
+			if (!res && bytes) throw std::bad_alloc();
+			return static_cast<T*>(res);
+		}
+	};
+
+	// Zwalnianie nie zaley od wza NUMA - kada instancja zwolni blok innej
+	template <class T, class U>
+	bool operator==(const huge_page_allocator<T>&, const huge_page_allocator<U>&) { return true; }
+	template <class T, class U>
+	bool operator!=(const huge_page_allocator<T>&, const huge_page_allocator<U>&) { return false; }
+}
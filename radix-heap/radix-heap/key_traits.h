@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace radix {
+	/**
+	 * Odwzorowanie kluczy na liczby bez znaku zachowujce porzdek (a < b <=> encode(a) < encode(b))
+	 * Radix heap porwnuje klucze przez XOR z ostatnio usunitym i numer najwyszego bitu, wic dziaa
+	 * tylko na liczbach bez znaku - pozostae typy kluczy s mapowane przy wstawianiu i odtwarzane przy zdejmowaniu
+	 *	- liczby bez znaku - bez zmian
+	 *	- liczby ze znakiem - odwrcony bit znaku (INT_MIN -> 0, -1 -> 0x7F..F, 0 -> 0x80..0)
+	 *	- float/double (IEEE-754) - nieujemne: odwrcony bit znaku, ujemne: odwrcone wszystkie bity
+	 *	  (-0.0 jest zamieniane na +0.0, NaN nie jest obsugiwany)
+	 *
+	 * bits_t - typ klucza w kolejce, encode()/decode() - konwersja w obie strony
+	 */
+	template <class key_t, class = void>
+	struct key_traits;
+
+	namespace detail {
+		// Najwyszy bit liczby bez znaku
+		template <class bits_t>
+		constexpr bits_t sign_bit() {
+			return static_cast<bits_t>(static_cast<bits_t>(1) << (sizeof(bits_t) * CHAR_BIT - 1));
+		}
+	}
+
+	template <class key_t>
+	struct key_traits<key_t, typename std::enable_if<std::is_integral<key_t>::value && std::is_unsigned<key_t>::value>::type> {
+		typedef key_t bits_t;
+
+		static bits_t encode(const key_t key) { return key; }
+		static key_t decode(const bits_t bits) { return bits; }
+	};
+
+	template <class key_t>
+	struct key_traits<key_t, typename std::enable_if<std::is_integral<key_t>::value && std::is_signed<key_t>::value>::type> {
+		typedef typename std::make_unsigned<key_t>::type bits_t;
+
+		static bits_t encode(const key_t key) {
+			return static_cast<bits_t>(static_cast<bits_t>(key) ^ detail::sign_bit<bits_t>());
+		}
+
+		static key_t decode(const bits_t bits) {
+			// Konwersja przez memcpy - rzutowanie wartoci > INT_MAX na typ ze znakiem przed C++20 zaley od implementacji
+			const bits_t tmp = static_cast<bits_t>(bits ^ detail::sign_bit<bits_t>());
+			key_t res;
+			std::memcpy(&res, &tmp, sizeof(res));
+			return res;
+		}
+	};
+
+	namespace detail {
+		// Wsplna implementacja dla float/double - bits_t to liczba o rozmiarze typu zmiennoprzecinkowego
+		template <class key_t, class uint_t>
+		struct float_key_traits {
+			static_assert(std::numeric_limits<key_t>::is_iec559 && sizeof(key_t) == sizeof(uint_t),
+				"Floating point key must be IEEE-754");
+			typedef uint_t bits_t;
+
+			static bits_t encode(key_t key) {
+				assert(key == key);
+				// -0.0 == +0.0, ale ma inny zapis - oba maj dawa ten sam klucz
+				if (key == 0) key = 0;
+				bits_t bits;
+				std::memcpy(&bits, &key, sizeof(bits));
+				return (bits & sign_bit<bits_t>()) ? ~bits : (bits | sign_bit<bits_t>());
+			}
+
+			static key_t decode(bits_t bits) {
+				bits = (bits & sign_bit<bits_t>()) ? (bits & ~sign_bit<bits_t>()) : ~bits;
+				key_t res;
+				std::memcpy(&res, &bits, sizeof(res));
+				return res;
+			}
+		};
+
+		// Typ wartoci elementu kolejki - pole value, dla par (radix::queue/lookup_queue) first
+		template <class element_t>
+		struct element_value {
+			typedef typename std::decay<decltype(std::declval<element_t>().value)>::type type;
+		};
+
+		template <class value_t, class key_t>
+		struct element_value<std::pair<value_t, key_t>> {
+			typedef value_t type;
+		};
+	}
+
+	template <>
+	struct key_traits<float> : detail::float_key_traits<float, std::uint32_t> {};
+
+	template <>
+	struct key_traits<double> : detail::float_key_traits<double, std::uint64_t> {};
+
+	// Typ klucza kolejki dla danego typu klucza uytkownika
+	template <class key_t>
+	using key_bits_t = typename key_traits<key_t>::bits_t;
+
+	/**
+	 * Kolejka z kluczami dowolnego typu obsugiwanego przez key_traits (float, double, liczby ze znakiem)
+	 * Nakadka na kolejk z kluczami key_bits_t<key_t> (RadixHeap, radix::queue, radix::lookup_queue,
+	 * radix::multilevel_heap, radix::dial_queue) - klucze s kodowane przy wstawianiu i dekodowane przy zdejmowaniu
+	 * Elementy zwracane s jako { value, key } z kluczem oryginalnego typu, wic kolejka dziaa z graph::dijkstra
+	 * (np. graf z wagami float)
+	 *
+	 * Przykad: mapped_queue<float, RadixHeap<unsigned, key_bits_t<float>>>
+	 *
+	 * Wymagania jak w kolejce bazowej: wstawiane klucze nie mniejsze ni ostatnio usunity
+	 * (po odwzorowaniu porzdek jest ten sam, wic dotyczy to te kluczy ujemnych)
+	 */
+	template <class key_t, class heap_t, class traits_t = key_traits<key_t>>
+	class mapped_queue {
+	public:
+		typedef typename traits_t::bits_t bits_t;
+		typedef heap_t heap_type;
+
+		typedef typename detail::element_value<typename std::decay<decltype(std::declval<heap_t&>().pop())>::type>::type value_type;
+
+		// Element zwracany przez pop()/top() - klucz w oryginalnym typie
+		struct element {
+			value_type value;
+			key_t key;
+		};
+
+		/**
+		 * Argumenty przekazywane do konstruktora kolejki bazowej (np. ilo elementw, alokator)
+		 */
+		template <class... Args>
+		explicit mapped_queue(Args&&... args) : _heap(std::forward<Args>(args)...) {}
+
+		void push(const value_type& item, const key_t key) {
+			_heap.push(item, traits_t::encode(key));
+		}
+
+		// Usuwanie minimum z kolejki
+		element pop() {
+			return _decode(_heap.pop());
+		}
+
+		// Najmniejszy element (kopia - klucz w kolejce jest zakodowany)
+		element top() {
+			return _decode(_heap.top());
+		}
+
+		// Zmiana priorytetu - tylko jeli kolejka bazowa j udostpnia
+		void reduce_priority(const value_type& item, const key_t new_key) {
+			_heap.reduce_priority(item, traits_t::encode(new_key));
+		}
+
+		void change_priority(const value_type& item, const key_t new_key) {
+			_heap.change_priority(item, traits_t::encode(new_key));
+		}
+
+		bool in_heap(const value_type& value) const {
+			return _heap.in_heap(value);
+		}
+
+		size_t size() const { return _heap.size(); }
+		bool empty() const { return _heap.empty(); }
+		void reset() { _heap.reset(); }
+
+		// Kolejka bazowa (klucze zakodowane)
+		heap_t& base() { return _heap; }
+		const heap_t& base() const { return _heap; }
+
+	private:
+		static_assert(std::is_same<typename std::remove_cv<decltype(traits_t::encode(key_t()))>::type, bits_t>::value,
+			"Key traits must encode to bits_t");
+
+		// Elementy radix::queue/lookup_queue to pary (warto, klucz), pozostaych kolejek - { value, key }
+		template <class stored_t>
+		static element _decode(const std::pair<value_type, stored_t>& el) {
+			return element{ el.first, traits_t::decode(el.second) };
+		}
+
+		template <class element_t>
+		static element _decode(const element_t& el) {
+			return element{ el.value, traits_t::decode(el.key) };
+		}
+
+		heap_t _heap;
+	};
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Polityki indeksu warto -> (pozycja w kubeku, priorytet) dla radix::lookup_queue
+ * - dense_lookup - tablica indeksowana wartoci, dla gstych identyfikatorw 0..n-1
+ * - hash_lookup - paska tablica haszujca z adresowaniem otwartym, dla rzadkich/niecakowitych identyfikatorw
+ *
+ * Obie wersje s alokowane z gry (konstruktor z przewidywan iloci wartoci) i w stanie ustalonym
+ * nie alokuj pamici
+ *
+ * Wsplne API:
+ *	- record_t* find(value) - rekord wartoci albo nullptr jeli jej nie ma
+ *	- record_t& at(value) - rekord wartoci, ktra na pewno jest w indeksie (bez sprawdzania)
+ *	- record_t& insert(value) - rekord wartoci; nowy ma pozycj NON_EXISTING_POS i wywoujcy
+ *	  musi j od razu ustawi (rekord z NON_EXISTING_POS oznacza brak wartoci)
+ *	- void erase(value)
+ *	- bool contains(value) const
+ *	- void clear()
+ * Wskaniki i referencje do rekordw s wane do nastpnego insert()
+ */
+namespace radix {
+	// Rekord indeksu - pozycja elementu w kubeku i jego aktualny priorytet
+	template <class key_t, class position_t = std::uint32_t>
+	struct lookup_record {
+		static const position_t NON_EXISTING_POS = std::numeric_limits<position_t>::max();
+
+		position_t position;
+		key_t key;
+	};
+
+	template <class key_t, class position_t>
+	const position_t lookup_record<key_t, position_t>::NON_EXISTING_POS;
+
+	/**
+	 * Funkcja haszujca dla indeksu
+	 * Liczby cakowite przechodz przez finalizer MurmurHash3 - std::hash bywa identycznoci,
+	 * a przy adresowaniu liniowym i tablicy o wielkoci 2^k to daje dugie acuchy kolizji
+	 */
+	template <class value_t, bool integral = std::is_integral<value_t>::value>
+	struct lookup_hash {
+		size_t operator()(const value_t& value) const {
+			std::uint64_t x = static_cast<std::uint64_t>(value);
+			x ^= x >> 33;
+			x *= 0xFF51AFD7ED558CCDull;
+			x ^= x >> 33;
+			x *= 0xC4CEB9FE1A85EC53ull;
+			x ^= x >> 33;
+			return static_cast<size_t>(x);
+		}
+	};
+
+	template <class value_t>
+	struct lookup_hash<value_t, false> : std::hash<value_t> {};
+
+	/**
+	 * Indeks dla gstych identyfikatorw - rekord wartoci v jest pod indeksem v
+	 * Wartoci spoza zakresu powikszaj tablic (jedyna alokacja poza konstruktorem)
+	 * position_t - typ pozycji w kubeku (jak w RadixHeap), dla kluczy 32-bitowych rekord ma 8B
+	 */
+	template <class value_t, class key_t, class position_t = std::uint32_t>
+	class dense_lookup {
+		static_assert(std::is_integral<value_t>::value, "Dense lookup requires integer values");
+	public:
+		typedef lookup_record<key_t, position_t> record_t;
+
+		/**
+		 * @param capacity ilo identyfikatorw (wartoci 0..capacity-1)
+		 */
+		explicit dense_lookup(const size_t capacity = 0) : _records(capacity, _empty()) {}
+
+		record_t* find(const value_t& value) {
+			const size_t i = static_cast<size_t>(value);
+			if (i >= _records.size() || _records[i].position == record_t::NON_EXISTING_POS) return nullptr;
+			return &_records[i];
+		}
+
+		record_t& at(const value_t& value) {
+			return _records[static_cast<size_t>(value)];
+		}
+
+		record_t& insert(const value_t& value) {
+			const size_t i = static_cast<size_t>(value);
+			if (i >= _records.size()) _records.resize(i + 1, _empty());
+			return _records[i];
+		}
+
+		void erase(const value_t& value) {
+			const size_t i = static_cast<size_t>(value);
+			if (i < _records.size()) _records[i] = _empty();
+		}
+
+		bool contains(const value_t& value) const {
+			const size_t i = static_cast<size_t>(value);
+			return i < _records.size() && _records[i].position != record_t::NON_EXISTING_POS;
+		}
+
+		void clear() {
+			std::fill(_records.begin(), _records.end(), _empty());
+		}
+	private:
+		static record_t _empty() {
+			record_t res;
+			res.position = record_t::NON_EXISTING_POS;
+			res.key = std::numeric_limits<key_t>::max();
+			return res;
+		}
+
+		std::vector<record_t> _records;
+	};
+
+	/**
+	 * Tablica haszujca z adresowaniem otwartym (sondowanie liniowe)
+	 * - wielko to potga 2, wspczynnik wypenienia <= 1/2
+	 * - wolne miejsce to rekord z pozycj NON_EXISTING_POS, nie ma osobnej flagi
+	 * - usuwanie przesuwa kolejne elementy acucha wstecz (bez "nagrobkw"), wic wyszukiwanie
+	 *   nie zwalnia po wielu operacjach erase()
+	 */
+	template <class value_t, class key_t, class hash_t = lookup_hash<value_t>, class position_t = std::uint32_t>
+	class hash_lookup {
+	public:
+		typedef lookup_record<key_t, position_t> record_t;
+
+		/**
+		 * @param capacity przewidywana maksymalna ilo wartoci jednoczenie w indeksie
+		 */
+		explicit hash_lookup(const size_t capacity = 0) : _count(0) {
+			size_t size = _MIN_SIZE;
+			while (size < capacity * 2) size *= 2;
+			_slots.assign(size, _empty());
+		}
+
+		record_t* find(const value_t& value) {
+			const size_t i = _find_slot(value);
+			return _is_free(i) ? nullptr : &_slots[i].record;
+		}
+
+		record_t& at(const value_t& value) {
+			return _slots[_find_slot(value)].record;
+		}
+
+		record_t& insert(const value_t& value) {
+			size_t i = _find_slot(value);
+			if (_is_free(i)) {
+				// Przekroczenie przewidywanej wielkoci - podwojenie tablicy
+				if ((_count + 1) * 2 > _slots.size()) {
+					_rehash(_slots.size() * 2);
+					i = _find_slot(value);
+				}
+				++_count;
+				_slots[i].value = value;
+			}
+			return _slots[i].record;
+		}
+
+		void erase(const value_t& value) {
+			size_t i = _find_slot(value);
+			if (_is_free(i)) return;
+			--_count;
+			const size_t mask = _slots.size() - 1;
+			// Przesuwanie wstecz elementw, dla ktrych zwolnione miejsce ley na drodze sondowania
+			for (size_t j = (i + 1) & mask; !_is_free(j); j = (j + 1) & mask) {
+				const size_t home = _hash(_slots[j].value) & mask;
+				// Czy home ley cyklicznie w (i, j]? Jeli tak, element zostaje na miejscu
+				if (((j - home) & mask) < ((j - i) & mask)) continue;
+				_slots[i] = std::move(_slots[j]);
+				i = j;
+			}
+			_slots[i] = _empty();
+		}
+
+		bool contains(const value_t& value) const {
+			return !_is_free(_find_slot(value));
+		}
+
+		void clear() {
+			std::fill(_slots.begin(), _slots.end(), _empty());
+			_count = 0;
+		}
+
+		size_t size() const {
+			return _count;
+		}
+	private:
+		struct slot {
+			value_t value;
+			record_t record;
+		};
+
+		static slot _empty() {
+			slot res;
+			res.value = value_t();
+			res.record.position = record_t::NON_EXISTING_POS;
+			res.record.key = std::numeric_limits<key_t>::max();
+			return res;
+		}
+
+		bool _is_free(const size_t i) const {
+			return _slots[i].record.position == record_t::NON_EXISTING_POS;
+		}
+
+		// Miejsce wartoci albo pierwsze wolne miejsce na jej drodze sondowania
+		size_t _find_slot(const value_t& value) const {
+			const size_t mask = _slots.size() - 1;
+			size_t i = _hash(value) & mask;
+			while (!_is_free(i) && !(_slots[i].value == value)) i = (i + 1) & mask;
+			return i;
+		}
+
+		void _rehash(const size_t new_size) {
+			std::vector<slot> old(new_size, _empty());
+			old.swap(_slots);
+			const size_t mask = new_size - 1;
+			for (slot& s : old) {
+				if (s.record.position == record_t::NON_EXISTING_POS) continue;
+				size_t i = _hash(s.value) & mask;
+				while (!_is_free(i)) i = (i + 1) & mask;
+				_slots[i] = std::move(s);
+			}
+		}
+
+		static const size_t _MIN_SIZE = 16;
+
+		std::vector<slot> _slots;
+		size_t _count;
+		hash_t _hash;
+	};
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "vector.h"
+#include "arena.h"
+#include "bucket_index.h"
+#include "simd.h"
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace radix {
+	/**
+	 * Radix heap o podstawie 2^digit_bits - klucz dzielony jest na cyfry po digit_bits bitw
+	 * Kubeek elementu to (poziom, cyfra): poziom - najwysza cyfra, na ktrej klucz rni si od ostatnio
+	 * usunitej wartoci, cyfra - warto tej cyfry w kluczu (2^digit_bits kubekw na poziom)
+	 * - redystrybucja przenosi elementy co najmniej o jeden poziom niej, wic element jest przenoszony
+	 *   najwyej BITS / digit_bits razy (w RadixHeap - do BITS razy), np. 16 zamiast 64 dla kluczy 64-bitowych
+	 * - wszystkie elementy kubeka na poziomie 0 maj ten sam klucz - pop() zdejmuje je bez redystrybucji
+	 * - niepuste kubeki: maska poziomw i maska cyfr dla kadego poziomu (dwa lsb na wyszukanie)
+	 * Kosztem jest 2^digit_bits razy wicej kubekw (np. 16 poziomw * 16 cyfr dla kluczy 64-bitowych)
+	 *
+	 * API jak RadixHeap (push/pop/top/reduce_priority/in_heap/reset), wic kolejka dziaa z graph::dijkstra
+	 *
+	 * @tparam digit_bits ilo bitw cyfry (1..5) - 1 odpowiada RadixHeap
+	 * @tparam use_lookup_tables lookup table (wartoci to liczby cakowite < element_count) - reduce_priority/in_heap
+	 *
+	 * Wymagania:
+	 *	- klucz jest liczb cakowit bez znaku
+	 *	- elementy wrzucane s nie mniejsze ni ostatni usunity element
+	 */
+	template <
+		class value_t,
+		class key_t,
+		unsigned digit_bits = 4,
+		bool use_lookup_tables = true,
+		class allocator_t = malloc_allocator<char>
+	>
+	class multilevel_heap {
+		static_assert(digit_bits >= 1 && digit_bits <= 5, "Digit must have 1..5 bits");
+
+		template <class T>
+		using _rebind_t = typename std::allocator_traits<allocator_t>::template rebind_alloc<T>;
+		typedef bucket_index<key_t> index_t;
+	public:
+		// Struktura przechowujca element kolejki
+		struct element {
+			element() : value(value_t()), key(0) {}
+
+			element(const value_t& value, const key_t key) : value(value), key(key) {}
+
+			element(value_t&& value, const key_t key) : value(std::move(value)), key(key) {}
+
+			value_t value;
+			key_t key;
+		};
+
+		typedef vector<element, false, _rebind_t<element>> bucket_t;
+		typedef allocator_t allocator_type;
+
+		// Ilo cyfr (poziomw) i kubekw na poziom
+		static const size_t LEVELS = (index_t::BITS + digit_bits - 1) / digit_bits;
+		static const size_t DIGITS = static_cast<size_t>(1) << digit_bits;
+
+		/**
+		 * Konstruktor
+		 * @param element_count maksymalna ilo elementw (wielko lookup table)
+		 * @param alloc alokator dla kubekw i lookup table
+		 */
+		explicit multilevel_heap(const size_t element_count = 0, const allocator_t& alloc = allocator_t())
+			: _buckets(_make_buckets(alloc, std::make_index_sequence<LEVELS * DIGITS>())),
+			_lookup_alloc(alloc), _element_count(use_lookup_tables ? element_count : 0) {
+			_digits.fill(0);
+			if (_element_count) _lookup = _allocate_lookup(detail::has_allocate_zeroed<_lookup_alloc_t>());
+		}
+
+		multilevel_heap(const multilevel_heap&) = delete;
+		multilevel_heap& operator=(const multilevel_heap&) = delete;
+
+		~multilevel_heap() {
+			if (_lookup) std::allocator_traits<_lookup_alloc_t>::deallocate(_lookup_alloc, _lookup, _element_count);
+		}
+
+		/**
+		 * Usuwanie minimum z kolejki
+		 * Zwraca (przez warto) najmniejszy element w kolejce
+		 */
+		element pop() {
+			const size_t b = _pull_least();
+			--_items_count;
+			element least = _buckets[b].pop_back();
+			_clear_if_empty(b);
+			_forget(least.value, _lookup_tag());
+			return least;
+		}
+
+		/**
+		 * Podgld najmniejszego elementu bez usuwania go z kolejki
+		 * Referencja jest wana do nastpnej operacji modyfikujcej kolejk
+		 */
+		const element& top() {
+			return _buckets[_pull_least()].back();
+		}
+
+		/**
+		 * Wstawianie nowej wartoci do kolejki
+		 *
+		 * @param item warto do wstawienia
+		 * @param key priorytet elementu do wstawienia
+		 */
+		void push(const value_t& item, const key_t key) {
+			assert(key >= _last_deleted);
+			++_items_count;
+			_place(element(item, key));
+		}
+
+		/**
+		 * Zmiana priorytetu elementu bdcego ju w kolejce (wymaga lookup table)
+		 *
+		 * @param item warto dla ktrej ma by zmieniony priorytet
+		 * @param new_key nowy priorytet (nie wikszy ni stary, nie mniejszy ni ostatnio usunity)
+		 */
+		void reduce_priority(const value_t& item, const key_t new_key) {
+			static_assert(use_lookup_tables, "reduce_priority() requires lookup tables");
+			lookup_entry& entry = _lookup[item];
+			assert(entry.position != NON_EXISTING_POS);
+			assert(new_key <= entry.key && new_key >= _last_deleted);
+			const size_t b = _bucket(entry.key);
+			if (b == _bucket(new_key)) {
+				entry.key = new_key;
+				_buckets[b][entry.position - 1].key = new_key;
+				return;
+			}
+
+			// Usunicie ze rodka kubeka - ostatni element przenoszony jest na zwolnione miejsce
+			const size_t item_pos = entry.position - 1;
+			bucket_t& bucket = _buckets[b];
+			const element last = bucket.pop_back();
+			if (item_pos != bucket.size()) {
+				bucket[item_pos] = last;
+				_lookup[last.value].position = _position(item_pos);
+			}
+			_clear_if_empty(b);
+			_place(element(item, new_key));
+		}
+
+		// Ilo elementw w kolejce
+		size_t size() const {
+			return _items_count;
+		}
+
+		// Czy kolejka jest pusta?
+		bool empty() const {
+			return _items_count == 0;
+		}
+
+		// Sprawdzenie czy element jest w kolejce (wymaga lookup table)
+		bool in_heap(const value_t& value) const {
+			static_assert(use_lookup_tables, "in_heap() requires lookup tables");
+			return _lookup[value].position != NON_EXISTING_POS;
+		}
+
+		/**
+		 * Oprnienie kolejki do ponownego uycia - koszt O(size()), kubeki zachowuj zaalokowan pami
+		 */
+		void reset() {
+			for (std::uint64_t levels = _levels; levels; levels &= levels - 1) {
+				const size_t level = detail::lsb64(levels);
+				for (std::uint32_t digits = _digits[level]; digits; digits &= digits - 1) {
+					bucket_t& bucket = _buckets[level * DIGITS + detail::lsb32(digits)];
+					if (use_lookup_tables)
+						for (const element& el : bucket) _forget(el.value, _lookup_tag());
+					bucket.clear();
+				}
+				_digits[level] = 0;
+			}
+			_levels = 0;
+			_items_count = 0;
+			_last_deleted = 0;
+		}
+
+	private:
+		// Rekord lookup table - pozycja w kubeku (+1, rekord z samych zer oznacza brak w kolejce) i priorytet
+		struct lookup_entry {
+			std::uint32_t position;
+			key_t key;
+		};
+
+		typedef _rebind_t<lookup_entry> _lookup_alloc_t;
+		typedef std::integral_constant<bool, use_lookup_tables> _lookup_tag;
+
+		template <size_t... I>
+		static std::array<bucket_t, LEVELS * DIGITS> _make_buckets(const allocator_t& alloc, std::index_sequence<I...>) {
+			return {{ (static_cast<void>(I), bucket_t(alloc))... }};
+		}
+
+		// Kubeek dla klucza: poziom * DIGITS + cyfra klucza na tym poziomie
+		size_t _bucket(const key_t key) const {
+			const size_t bit = index_t::find(key, _last_deleted);
+			const size_t level = bit ? (bit - 1) / digit_bits : 0;
+			return level * DIGITS + static_cast<size_t>((key >> (level * digit_bits)) & (DIGITS - 1));
+		}
+
+		// Wstawienie elementu do jego kubeka (bez zmiany iloci elementw)
+		void _place(element&& el) {
+			const size_t b = _bucket(el.key);
+			bucket_t& bucket = _buckets[b];
+			bucket.push_back(std::move(el));
+			_set_occupied(b);
+			_track(bucket.back().value, bucket.size() - 1, bucket.back().key, _lookup_tag());
+		}
+
+		void _set_occupied(const size_t b) {
+			_levels |= static_cast<std::uint64_t>(1) << (b / DIGITS);
+			_digits[b / DIGITS] |= static_cast<std::uint32_t>(1) << (b % DIGITS);
+		}
+
+		void _clear_if_empty(const size_t b) {
+			if (!_buckets[b].empty()) return;
+			std::uint32_t& digits = _digits[b / DIGITS];
+			digits &= ~(static_cast<std::uint32_t>(1) << (b % DIGITS));
+			if (!digits) _levels &= ~(static_cast<std::uint64_t>(1) << (b / DIGITS));
+		}
+
+		/**
+		 * Kubeek z elementami minimalnymi
+		 * Pierwszy niepusty kubeek na poziomie 0 zawiera elementy o jednym kluczu - to jest minimum
+		 * Wyej: pierwszy niepusty kubeek najniszego poziomu ma minimum kolejki, staje si ono ostatnio
+		 * usunit wartoci, a elementy kubeka trafiaj na nisze poziomy (minimum - na poziom 0)
+		 */
+		size_t _pull_least() {
+			assert(_items_count > 0);
+			size_t level = detail::lsb64(_levels);
+			size_t b = level * DIGITS + detail::lsb32(_digits[level]);
+			if (level) {
+				bucket_t& src = _buckets[b];
+				_last_deleted = simd::min_key(src.data(), src.size(), &element::key);
+				for (size_t j = src.size(); j-- > 0;) {
+					const size_t new_bucket = _bucket(src[j].key);
+					bucket_t& dst = _buckets[new_bucket];
+					dst.push_back(std::move(src[j]));
+					_set_occupied(new_bucket);
+					_set_position(dst.back().value, dst.size() - 1, _lookup_tag());
+				}
+				src.clear();
+				_clear_if_empty(b);
+				b = detail::lsb32(_digits[0]);
+			}
+			// Na poziomie 0 kubeek wyznacza klucz - aktualizacja ostatnio usunitej wartoci nie zmienia kubekw
+			_last_deleted = _buckets[b].back().key;
+			return b;
+		}
+
+		/**
+		 * Aktualizacja lookup table - przy wyczonej lookup table wersje bez efektu
+		 */
+		void _track(const value_t& value, const size_t pos, const key_t key, std::true_type) {
+			lookup_entry& entry = _lookup[value];
+			entry.position = _position(pos);
+			entry.key = key;
+		}
+
+		void _track(const value_t&, const size_t, const key_t, std::false_type) {}
+
+		void _set_position(const value_t& value, const size_t pos, std::true_type) {
+			_lookup[value].position = _position(pos);
+		}
+
+		void _set_position(const value_t&, const size_t, std::false_type) {}
+
+		void _forget(const value_t& value, std::true_type) {
+			_lookup[value] = lookup_entry();
+		}
+
+		void _forget(const value_t&, std::false_type) {}
+
+		static std::uint32_t _position(const size_t pos) {
+			assert(pos < std::numeric_limits<std::uint32_t>::max());
+			return static_cast<std::uint32_t>(pos + 1);
+		}
+
+		// Wyzerowana lookup table - jak w RadixHeap (calloc()/mmap, inne alokatory - memset())
+		lookup_entry* _allocate_lookup(std::true_type) {
+			return _lookup_alloc.allocate_zeroed(_element_count);
+		}
+
+		lookup_entry* _allocate_lookup(std::false_type) {
+			lookup_entry *res = std::allocator_traits<_lookup_alloc_t>::allocate(_lookup_alloc, _element_count);
+			std::memset(res, 0, _element_count * sizeof(lookup_entry));
+			return res;
+		}
+
+		// Zakodowana pozycja oznaczajca brak w kolejce
+		static const std::uint32_t NON_EXISTING_POS = 0;
+
+		// Ostatnio usunita warto
+		key_t _last_deleted = 0;
+		// Ilo elementw w kolejce
+		size_t _items_count = 0;
+		// Maska niepustych poziomw i maski niepustych kubekw (cyfr) kadego poziomu
+		std::uint64_t _levels = 0;
+		std::array<std::uint32_t, LEVELS> _digits;
+		std::array<bucket_t, LEVELS * DIGITS> _buckets;
+
+		_lookup_alloc_t _lookup_alloc;
+		// Lookup table - pozycje i priorytety wartoci
+		lookup_entry* _lookup = nullptr;
+		size_t _element_count;
+	};
+
+	template <class value_t, class key_t, unsigned digit_bits, bool use_lookup_tables, class allocator_t>
+	const size_t multilevel_heap<value_t, key_t, digit_bits, use_lookup_tables, allocator_t>::LEVELS;
+	template <class value_t, class key_t, unsigned digit_bits, bool use_lookup_tables, class allocator_t>
+	const size_t multilevel_heap<value_t, key_t, digit_bits, use_lookup_tables, allocator_t>::DIGITS;
+	template <class value_t, class key_t, unsigned digit_bits, bool use_lookup_tables, class allocator_t>
+	const std::uint32_t multilevel_heap<value_t, key_t, digit_bits, use_lookup_tables, allocator_t>::NON_EXISTING_POS;
+}
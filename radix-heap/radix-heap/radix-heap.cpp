@@ -1,10 +1,10 @@
 // radix-heap.cpp : Defines the entry point for the console application.
 //
 
-#define USE_ABM_LZCNT 0
 #include "stdafx.h"
 #include "vector.h"
 #include "radix.h"
+#include "sort.h"
 #include <queue>
 #include <vector>
 #include <list>
@@ -91,8 +91,13 @@ int main()
 	for (unsigned i = 0; i < vec_test; ++i) test.push_back(i);
 	std::sort(test.begin(), test.end());
 #endif
+#if _BIG_DEBUG == 8 // radix::radix_heap_sort
+	std::vector<unsigned> test, sorted(vec_test);
+	for (unsigned i = 0; i < vec_test; ++i) test.push_back(i);
+	radix::radix_heap_sort(test.data(), test.size(), sorted.data());
+#endif
 #else
-	printf("%d", __lzcnt(8 ^ 11) + 1);
+	printf("%d", static_cast<int>(radix::bucket_index<unsigned>::find(8, 11)));
 #endif
 	 
 	return 0;
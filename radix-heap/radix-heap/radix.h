@@ -1,7 +1,22 @@
 #pragma once
 
 #include "vector.h"
+#include "arena.h"
+#include "bucket_index.h"
+#include "simd.h"
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 /**
  * Czy ma by uyte cachowanie pozycji i priorytetw?
@@ -12,14 +27,6 @@
  */
 #ifndef USE_LOOKUP_TABLES
 #define USE_LOOKUP_TABLES 1
-#endif
- /**
-  * Czy uywa __lzcnt() wymagajcego obsugi SSE4 przez procesor
-  * Jeli 0, bdzie uyte nieznacznie wolniejsze _BitScanReverse()
-  * Jeli CPU nie obsuguje ABM wystpi undefined behaviour
-  */
-#ifndef USE_ABM_LZCNT
-#define USE_ABM_LZCNT 1
 #endif
   /**
    * Czy Szukanie minimum w kubeku ma si odbywa przy kadej operacji (bdzie cachowane dla pop()),
@@ -31,18 +38,96 @@
 #ifndef CACHE_MIN
 #define CACHE_MIN 1
 #endif
+   /**
+	* Czy kubeki maj przechowywa klucze i wartoci w osobnych tablicach (SoA)?
+	* Klucze caego kubeka s wtedy cige i numery kubekw docelowych przy redystrybucji
+	* liczone s wektorowo (AVX2/SSE4.1, dla kluczy 32-bitowych)
+	* Kosztem jest dostp do dwch tablic przy kadym push/pop
+	*/
+#ifndef SOA_BUCKETS
+#define SOA_BUCKETS 0
+#endif
+
+namespace radix {
+	/**
+	 * Konfiguracja RadixHeap jako parametr szablonu - w jednym programie mog by kolejki o rnych
+	 * ustawieniach (np. z lookup table dla alg. Dijkstry i bez niej dla zwykego push/pop)
+	 * Domylne wartoci bior si z ww. makr (i AUTO_RESIZE_DOWN z vector.h), wic stary kod dziaa bez zmian
+	 * Wyczone opcje nie kosztuj nic w czasie dziaania - odpowiadajcy im kod nie jest generowany
+	 *
+	 * @tparam use_lookup_tables jak USE_LOOKUP_TABLES
+	 * @tparam use_cache_min jak CACHE_MIN
+	 * @tparam use_soa_buckets jak SOA_BUCKETS
+	 * @tparam use_auto_resize_down jak AUTO_RESIZE_DOWN (dla kubekw)
+	 */
+	template <
+		bool use_lookup_tables = USE_LOOKUP_TABLES != 0,
+		bool use_cache_min = CACHE_MIN != 0,
+		bool use_soa_buckets = SOA_BUCKETS != 0,
+		bool use_auto_resize_down = AUTO_RESIZE_DOWN != 0
+	>
+	struct heap_policy {
+		static const bool lookup_tables = use_lookup_tables;
+		static const bool cache_min = use_cache_min;
+		static const bool soa_buckets = use_soa_buckets;
+		static const bool auto_resize_down = use_auto_resize_down;
+	};
+
+	template <bool l, bool c, bool s, bool r>
+	const bool heap_policy<l, c, s, r>::lookup_tables;
+	template <bool l, bool c, bool s, bool r>
+	const bool heap_policy<l, c, s, r>::cache_min;
+	template <bool l, bool c, bool s, bool r>
+	const bool heap_policy<l, c, s, r>::soa_buckets;
+	template <bool l, bool c, bool s, bool r>
+	const bool heap_policy<l, c, s, r>::auto_resize_down;
+
+	// Gotowe zestawy: alg. Dijkstry (zmiana priorytetu) i sama kolejka push/pop
+	typedef heap_policy<true, true, false, false> dijkstra_policy;
+	typedef heap_policy<false, false, false, false> lean_policy;
+
+	namespace detail {
+		/**
+		 * Minima kubekw (CACHE_MIN) - przy wyczonym cache pusta struktura z operacjami bez efektu
+		 */
+		template <bool enabled, class key_t, size_t count>
+		struct bucket_minima {
+			void reset() { _min.fill(std::numeric_limits<key_t>::max()); }
+			void update(const size_t bucket, const key_t key) { if (key < _min[bucket]) _min[bucket] = key; }
+			void set(const size_t bucket, const key_t key) { _min[bucket] = key; }
+			key_t get(const size_t bucket) const { return _min[bucket]; }
+		private:
+			std::array<key_t, count> _min;
+		};
+
+		template <class key_t, size_t count>
+		struct bucket_minima<false, key_t, count> {
+			void reset() {}
+			void update(const size_t, const key_t) {}
+			void set(const size_t, const key_t) {}
+			key_t get(const size_t) const { return std::numeric_limits<key_t>::max(); }
+		};
+	}
+}
 
    /**
 	* Radix heap - "kopiec kubekowy"
-	* Dziaa zakadajc, e priorytet jest liczb cakowit >= 0
+	* Dziaa zakadajc, e priorytet jest liczb cakowit >= 0 (unsigned, 8/16/32/64 bity)
+	* Ilo kubekw wynika z szerokoci klucza i jest znana w czasie kompilacji
 	* Pozwala na implementacj alg. Dijkstry o zoonoci ~O(m+n*logC)
+	* position_t - typ pozycji w kubeku w lookup table (uint16/uint32/uint64), musi pomieci
+	* najwikszy kubeek; wszy typ to mniejszy rekord lookup table (np. 8B dla kluczy 32-bitowych)
 	* Przy okazji jest znacznie prostszy w implementacji ni np. Kopiec Fibonacciego
 	* Wersja wykorzystujca lookup table (USE_LOOKUP_TABLES = 1) dziaa tylko jeli value_t
 	* jest liczb cakowit cakowit (np. numer wierzchoka w alg. Dijkstry).
+	* key_t - liczba cakowita bez znaku; klucze float/double/ze znakiem przez radix::mapped_queue (key_traits.h)
+	* policy_t - konfiguracja (radix::heap_policy), domylnie wedug makr
+	* allocator_t - alokator kubekw i tablic pomocniczych (przepinany na waciwe typy), np.
+	* radix::arena_allocator (arena.h) albo std::pmr::polymorphic_allocator; domylnie malloc/realloc
 	*
 	* Testy jednostkowe, cznie 20+ z uyciem boost::test potwierdzaj poprawno dziaania
 	*
-	* Ww. dyrektywy uywane s do warunkowej kompilacji kodu dziki czemu mona go dostosowa
+	* Ww. dyrektywy (i policy_t) uywane s do warunkowej kompilacji kodu dziki czemu mona go dostosowa
 	* w zalenoci od wymaga (zuycie pamici/szybko). Wczenie obu rodzajw cache moe
 	* znacznie przyspieszy dziaanie kodu, ALE powoduje zuycie ~40% wicej pamici
 	*
@@ -62,15 +147,29 @@
 	*
 	* Autor: Tomasz Stasiak
 	*/
-template <class value_t, class key_t>
+template <
+	class value_t,
+	class key_t,
+	class position_t = std::uint32_t,
+	class policy_t = radix::heap_policy<>,
+	class allocator_t = radix::malloc_allocator<char>
+>
 class RadixHeap {
 public:
 	// Struktura przechowujca element kolejki
 	struct element {
+		// Znacznik dla konstrukcji wartoci w miejscu (emplace)
+		struct in_place_t {};
+
 		element() : value(value_t()), key(0) {}
 
 		element(const value_t& value, const key_t key) : value(value), key(key) {}
 
+		element(value_t&& value, const key_t key) : value(std::move(value)), key(key) {}
+
+		template <class... Args>
+		element(in_place_t, const key_t key, Args&&... args) : value(std::forward<Args>(args)...), key(key) {}
+
 		value_t value;
 		key_t key;
 
@@ -79,100 +178,130 @@ public:
 		}
 	};
 
+	typedef policy_t policy;
+	typedef allocator_t allocator_type;
+
+private:
+	// Konfiguracja - stae czasu kompilacji, wyczone gazie kodu s usuwane przez kompilator
+	static const bool _LOOKUP_TABLES = policy_t::lookup_tables;
+	static const bool _CACHE_MIN = policy_t::cache_min;
+	static const bool _SOA_BUCKETS = policy_t::soa_buckets;
+
+	template <class T>
+	using _rebind_t = typename std::allocator_traits<allocator_t>::template rebind_alloc<T>;
+
+public:
 	// Typ okrelajcy poszczeglne kubeki
-	typedef vector<element> bucket_t;
-#if USE_LOOKUP_TABLES
-	// Typ przechowujcy miejsce w kubeku dla poszczceglnych wartoci
-	// Jeli elementw jest mao (<2^8/2^16), moe by mniejszy typ - mniej pamici
-	typedef size_t position_t;
-#endif
+	typedef typename std::conditional<_SOA_BUCKETS,
+		soa_vector<element, value_t, key_t, policy_t::auto_resize_down, _rebind_t<element>>,
+		vector<element, policy_t::auto_resize_down, _rebind_t<element>>>::type bucket_t;
+
+	static_assert(std::is_integral<position_t>::value && std::is_unsigned<position_t>::value,
+		"Position must be unsigned integer type");
+
+	/**
+	 * Rekord lookup table - pozycja w kubeku i aktualny priorytet wartoci obok siebie,
+	 * wic aktualizacja elementu to jedno chybienie w cache zamiast dwch
+	 * Pozycja przechowywana jest jako (pozycja + 1) - rekord z samych zer oznacza brak w kolejce,
+	 * wic tablica nie wymaga inicjalizacji (strony wyzerowane przez system, alokowane przy pierwszym uyciu)
+	 */
+	struct lookup_entry {
+		position_t position;
+		key_t key;
+	};
 
 	/**
 	 * Konstruktor
 	 * @param element_count maksymalna ilo elementw (np. wierzchokw) przechowywanych w kopcu
+	 * (bez lookup table nie jest potrzebna)
+	 * @param alloc alokator dla kubekw, lookup table i bufora redystrybucji
 	 */
-#if USE_LOOKUP_TABLES
-	RadixHeap() : _items_count(0), _element_count(0) {}
-
-	explicit RadixHeap(const position_t element_count) : _element_count(element_count) {
-		// Inicjalizacja lookup tables
-		_element_positions = new position_t[element_count];
-		_current_priorities = new key_t[element_count];
-		for (position_t i = 0; i < element_count; ++i) {
-			_element_positions[i] = NON_EXISTING_POS;
-			_current_priorities[i] = NON_EXISTING_KEY;
-		}
-#else
-	RadixHeap(const size_t useless = 0) {
-#endif
+	RadixHeap() : RadixHeap(0) {}
+
+	explicit RadixHeap(const size_t element_count, const allocator_t& alloc = allocator_t())
+		: _targets(alloc), _buckets(_make_buckets(alloc, std::make_index_sequence<BUCKETS_COUNT>())), _batch(alloc),
+		_lookup_alloc(alloc), _element_count(_LOOKUP_TABLES ? element_count : 0) {
+		// Wyzerowana lookup table (bez zapisywania caej tablicy, jeli alokator na to pozwala)
+		if (_element_count) _lookup = _allocate_lookup(radix::detail::has_allocate_zeroed<_lookup_alloc_t>());
 		_items_count = 0;
-		// ilo kubekow ~ ilo bitw maksymalnej wielkoci klucza
-		_buckets_no = static_cast<key_t>(ceil(log2(MAX_PRIORITY)) + 1);
 		_last_deleted = 0;
-
-		// Alokacja kubekw
-		_buckets = new bucket_t[_buckets_no];
-#if CACHE_MIN
-		_buckets_min = new key_t[_buckets_no];
-		for (size_t i = 0; i < _buckets_no; ++i) _buckets_min[i] = NON_EXISTING_KEY;
-#endif
+		_occupied = 0;
+		_buckets_min.reset();
 	}
 
+	RadixHeap(const RadixHeap&) = delete;
+	RadixHeap& operator=(const RadixHeap&) = delete;
+
 	// Destruktor
 	~RadixHeap() {
-		delete[] _buckets;
-#if CACHE_MIN
-		delete[] _buckets_min;
-#endif
-#if USE_LOOKUP_TABLES
-		delete[] _element_positions;
-		delete[] _current_priorities;
-#endif
+		if (_lookup) std::allocator_traits<_lookup_alloc_t>::deallocate(_lookup_alloc, _lookup, _element_count);
+	}
+
+	/**
+	 * Przybliona ilo pamici (w bajtach) potrzebnej kolejce na element_count elementw:
+	 * lookup table, kubeki z zapasem na wzrost geometryczny (i bufory zwolnione przy wzrocie) oraz bufor redystrybucji
+	 * Np. jako wielko pierwszego bloku radix::arena
+	 */
+	static size_t memory_estimate(const size_t element_count) {
+		return (_LOOKUP_TABLES ? element_count * sizeof(lookup_entry) : 0)
+			+ 6 * element_count * sizeof(element) + element_count;
 	}
 
 	/**
 	 * Usuwanie minimum z kolejki
-	 *
-	 * Jeli jest kilka elementw minimalnych o tej samej wartoci (priorytecie)
-	 * to delete_min bdzie je pakowao cigle do kubeka #0 po usuniciu pierwszego z nich
-	 * wic jeli co jest w #0 mona pomin redystrybucj
-	 *
-	 * Zwraca najmniejszy element w kolejce
+	 * Zwraca (przez warto) najmniejszy element w kolejce
 	 */
-	element& pop() {
-		assert(_items_count > 0);
-		if (!_items_count) return element();
-		// Jeli co jest w kubeku #0 to jest to minimum
-		if (!_buckets[0].empty()) return _remove_least();
-
-		// Szukanie pierwszego, niepustego kubeka
-		size_t i = 0;
-		for (; _buckets[i].empty(); ++i);
-		// Usunity jest element o najmniejszym priorytecie z tego kubeka
-#if CACHE_MIN
-		_last_deleted = _buckets_min[i];
-		_buckets_min[i] = NON_EXISTING_KEY;
-#else
-		_last_deleted = NON_EXISTING_KEY;
-		for (size_t j = 0; j < _buckets[i].size(); ++j)
-			_last_deleted = element::min(_buckets[i][j].key, _last_deleted);
-#endif
+	element pop() {
+		_pull_least();
+		return _remove_least();
+	}
 
-		// Redystrybucja elementw
-		while (!_buckets[i].empty()) {
-			const element& el = _buckets[i].pop_back();
-			const key_t new_bucket = _find_bucket(el.key);
-			_buckets[new_bucket].push_back(el);
-#if CACHE_MIN
-			_buckets_min[new_bucket] = element::min(_buckets_min[new_bucket], el.key);
-#endif
-#if USE_LOOKUP_TABLES
-			// Element przenosimy na koniec nowego kubeka
-			_element_positions[el.value] = _buckets[new_bucket].size() - 1;
-#endif
+	/**
+	 * Zdjcie naraz wszystkich elementw o najmniejszym priorytecie (np. kolejny poziom BFS, grafy o wagach 1)
+	 * Po redystrybucji wszystkie s w kubeku #0 - kubeek jest zamieniany z buforem wyniku (bez kopiowania),
+	 * a wpisy lookup table czyszczone w jednej ptli
+	 * Zwracana referencja jest wana do nastpnego pop_min_batch()/pop_until()/reset(); mona w tym czasie
+	 * wrzuca nowe elementy (take o tym samym priorytecie - trafi do kolejki, nie do wyniku)
+	 */
+	const bucket_t& pop_min_batch() {
+		_pull_least();
+		_batch.clear();
+		_take_least();
+		return _batch;
+	}
+
+	/**
+	 * Zdjcie wszystkich elementw o priorytecie <= key, w kolejnoci niemalejcych priorytetw
+	 * Jak pop_min_batch() - cae grupy elementw minimalnych naraz, referencja wana do nastpnego wywoania
+	 * Kolejna grupa nie jest redystrybuowana, wic po wywoaniu mona wrzuca elementy o priorytetach >= key
+	 *
+	 * @param key najwikszy zdejmowany priorytet
+	 */
+	const bucket_t& pop_until(const key_t key) {
+		_batch.clear();
+		while (_items_count) {
+			if (_buckets[0].empty()) {
+				// Minimum sprawdzane przed redystrybucj - _last_deleted nie przekracza key,
+				// wic po wywoaniu wolno wrzuca elementy o priorytetach >= key
+				const size_t i = index_t::first(_occupied);
+				const key_t least = _bucket_least(i);
+				if (least > key) break;
+				_pull_bucket(i, least);
+			}
+			else if (_last_deleted > key) break;
+			_take_least();
 		}
+		return _batch;
+	}
 
-		return _remove_least();
+	/**
+	 * Podgld najmniejszego elementu bez usuwania go z kolejki
+	 * Moe wymaga redystrybucji kubeka, dlatego nie jest const
+	 * Referencja jest wana do nastpnej operacji modyfikujcej kolejk
+	 */
+	typename bucket_t::const_reference top() {
+		_pull_least();
+		return _buckets[0].back();
 	}
 
 	/**
@@ -182,42 +311,107 @@ public:
 	 * @param key priorytet elementu do wstawienia
 	 */
 	void push(const value_t& item, const key_t key) {
+		emplace(key, item);
+	}
+
+	void push(value_t&& item, const key_t key) {
+		emplace(key, std::move(item));
+	}
+
+	/**
+	 * Wstawianie wartoci konstruowanej bezporednio w kubeku
+	 *
+	 * @param key priorytet elementu do wstawienia
+	 * @param args argumenty konstruktora value_t
+	 */
+	template <class... Args>
+	void emplace(const key_t key, Args&&... args) {
 		assert(MAX_PRIORITY >= key);
 
 		++_items_count;
 		// Numer kubeka do ktrego powinien wyldowa ten element
-		const key_t bucket_no = _find_bucket(key);
-		const element new_element(item, key);
-		_buckets[bucket_no].push_back(new_element);
-#if CACHE_MIN
-		_buckets_min[bucket_no] = element::min(_buckets_min[bucket_no], key);
-#endif
-#if USE_LOOKUP_TABLES
-		_element_positions[item] = _buckets[bucket_no].size() - 1;
-		_current_priorities[item] = key;
-#endif
+		const size_t bucket_no = _find_bucket(key);
+		_buckets[bucket_no].emplace_back(typename element::in_place_t(), key, std::forward<Args>(args)...);
+		_set_occupied(bucket_no);
+		_buckets_min.update(bucket_no, key);
+		_track(_buckets[bucket_no].back().value, _buckets[bucket_no].size() - 1, key, _lookup_tag());
 	}
 
-#if USE_LOOKUP_TABLES
 	/**
-	 * Zmiana priorytetu elementu bdcego ju w kolejce
+	 * Wstawienie n elementw naraz (np. wiele rde alg. Dijkstry)
+	 * - numery kubekw i ich licznoci liczone s w jednym przebiegu, kubeki powikszane s dokadnie
+	 *   o potrzebn ilo miejsca, a elementy zapisywane bezporednio na swoje pozycje (razem z lookup table)
+	 * - dla duych n (od PARALLEL_BUILD elementw na wtek) oba przebiegi dzielone s midzy wtki;
+	 *   dla value_t, ktry nie jest trywialnie kopiowalny, zapis elementw jest jednowtkowy (emplace_back)
+	 * Jak dla push(): klucze nie mniejsze ni ostatnio usunity, przy lookup table unikalne wartoci
+	 *
+	 * @param values wartoci
+	 * @param keys priorytety
+	 * @param n ilo elementw
+	 * @param threads maksymalna ilo wtkw (0 - std::thread::hardware_concurrency())
+	 */
+	void build(const value_t* values, const key_t* keys, const size_t n, unsigned threads = 0) {
+		if (!n) return;
+		if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+		const unsigned chunks = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, n / PARALLEL_BUILD)));
+
+		// Przebieg 1 - numery kubekw, licznoci i minima dla kadego fragmentu
+		_targets.clear();
+		_targets.append_uninitialized(n);
+		std::vector<std::array<size_t, BUCKETS_COUNT>> offsets(chunks);
+		std::vector<std::array<key_t, BUCKETS_COUNT>> minima(_CACHE_MIN ? chunks : 0);
+		_parallel_chunks(n, chunks, [&](const unsigned t, const size_t begin, const size_t end) {
+			radix::simd::bucket_numbers(keys + begin, end - begin, _last_deleted, _targets.data() + begin);
+			std::array<size_t, BUCKETS_COUNT>& counts = offsets[t];
+			counts.fill(0);
+			if (_CACHE_MIN) minima[t].fill(NON_EXISTING_KEY);
+			for (size_t i = begin; i < end; ++i) {
+				assert(keys[i] >= _last_deleted);
+				const size_t b = _targets[i];
+				++counts[b];
+				if (_CACHE_MIN && keys[i] < minima[t][b]) minima[t][b] = keys[i];
+			}
+		});
+
+		// Licznoci -> pozycje startowe fragmentw w kubekach, kubeki powikszone dokadnie o sum
+		for (size_t b = 0; b < BUCKETS_COUNT; ++b) {
+			size_t pos = _buckets[b].size();
+			for (unsigned t = 0; t < chunks; ++t) {
+				const size_t count = offsets[t][b];
+				offsets[t][b] = pos;
+				pos += count;
+				if (_CACHE_MIN) _buckets_min.update(b, minima[t][b]);
+			}
+			if (pos == _buckets[b].size()) continue;
+			_grow_bucket(_buckets[b], pos - _buckets[b].size(), _trivial_value_t());
+			_set_occupied(b);
+		}
+
+		// Przebieg 2 - zapis elementw i lookup table (fragmenty pisz w rozczne miejsca)
+		_scatter(values, keys, n, chunks, offsets, _trivial_value_t());
+		_items_count += n;
+	}
+
+	/**
+	 * Zmiana priorytetu elementu bdcego ju w kolejce (wymaga lookup table)
 	 *
 	 * @param item warto dla ktrej ma by zmieniony priorytet
 	 * @param new_key nowy priorytet dla elementu
 	 */
 	void reduce_priority(const value_t& item, const key_t new_key) {
+		static_assert(_LOOKUP_TABLES, "reduce_priority() requires lookup tables");
 		// Usuwanie elementu z kolejki
-		const key_t old_key = _current_priorities[item];
-		const key_t bucket_no = _find_bucket(old_key);
-		const position_t item_pos = _element_positions[item];
+		lookup_entry& entry = _lookup[item];
+		const key_t old_key = entry.key;
+		const size_t bucket_no = _find_bucket(old_key);
+		assert(entry.position != NON_EXISTING_POS);
+		const size_t item_pos = entry.position - 1;
 		assert(new_key <= old_key);
 		// Jeli element pozostaje w tym kubeku, to nie trzeba go przesuwa
 		if (bucket_no == _find_bucket(new_key)) {
-			_current_priorities[item] = new_key;
+			entry.key = new_key;
 			_buckets[bucket_no][item_pos].key = new_key;
-#if CACHE_MIN
-			_buckets_min[bucket_no] = element::min(_buckets_min[bucket_no], new_key);
-#endif
+			_buckets_min.update(bucket_no, new_key);
 			return;
 		}
 		// 2 moliwoci - usuwamy z koca kubeka, bd z jego rodka
@@ -225,20 +419,47 @@ public:
 		// Usuwamy ze rodka - aktualizacja miejsca dla ostatniego elementu
 		if (item_pos != _buckets[bucket_no].size()) {
 			_buckets[bucket_no][item_pos] = last;
-			_element_positions[last.value] = item_pos;
+			_lookup[last.value].position = _position(item_pos);
 		}
+		_clear_if_empty(bucket_no);
 
-#if CACHE_MIN
 		// Przypadek szczeglny - zmieniamy priorytet najmniejszego elementu
 		// W takim przypadku trzeba odszuka element minimalny w tym kubeku
-		_fix_minimum(bucket_no, old_key, new_key);
-#endif
+		if (_CACHE_MIN) _fix_minimum(bucket_no, old_key, new_key);
 
 		// Dodanie elementu jeszcze raz
 		--_items_count;
 		push(item, new_key);
 	}
-#endif
+
+	/**
+	 * Scalenie z inn kolejk - wszystkie elementy other trafiaj do tej kolejki, other zostaje pusta (jak po reset())
+	 * - obie kolejki s sprowadzane do wsplnej ostatnio usunitej wartoci (mniejszej z dwch), przenoszone
+	 *   s przy tym tylko elementy kubekw, ktrych zakres kluczy si zmienia (_rebase())
+	 * - kubeki o tych samych numerach obejmuj wtedy te same klucze i s czone parami: do pustego
+	 *   kubeka przejmowany jest bufor kubeka other (bez kopiowania), do niepustego - dopisanie na koniec
+	 * - wpisy lookup table przeniesionych wartoci s przepisywane z other (pozycja w nowym kubeku)
+	 * Koszt O(ilo przeniesionych elementw) zamiast O(n log C) dla pop() + push()
+	 * Przy lookup table wartoci w obu kolejkach musz by rne i mniejsze od element_count tej kolejki
+	 *
+	 * @param other kolejka, ktrej elementy s przenoszone
+	 */
+	void merge(RadixHeap& other) {
+		assert(this != &other);
+		const key_t last = std::min(_last_deleted, other._last_deleted);
+		_rebase(last);
+		other._rebase(last);
+		for (size_t b = 0; b < BUCKETS_COUNT; ++b) {
+			bucket_t& src = other._buckets[b];
+			if (src.empty()) continue;
+			_buckets_min.update(b, other._buckets_min.get(b));
+			const size_t from = _append(_buckets[b], src);
+			_set_occupied(b);
+			_adopt(_buckets[b], from, other, _lookup_tag());
+		}
+		_items_count += other._items_count;
+		other.reset();
+	}
 
 	// Ilo elementw w kolejce
 	size_t size() const {
@@ -250,79 +471,376 @@ public:
 		return size() == 0;
 	}
 
-#if USE_LOOKUP_TABLES
-	// Sprawdzenie czy element jest w kopcu
+	/**
+	 * Oprnienie kolejki do ponownego uycia (np. jedna kolejka na wtek dla wielu zapyta)
+	 * Wartoci zdjte przez pop() maj ju wyczyszczone wpisy lookup table, wic czyszczone s
+	 * tylko wpisy elementw pozostaych w kubekach - koszt O(size()), a nie O(element_count)
+	 * Kubeki zachowuj zaalokowan pami
+	 */
+	void reset() {
+		_batch.clear();
+		_reset_bucket(0);
+		for (mask_t rest = _occupied; rest; rest &= rest - 1) _reset_bucket(index_t::first(rest));
+		_items_count = 0;
+		_last_deleted = 0;
+		_occupied = 0;
+		_buckets_min.reset();
+	}
+
+	// Sprawdzenie czy element jest w kopcu (wymaga lookup table)
 	bool in_heap(const value_t& value) const {
-		return _element_positions[value] != NON_EXISTING_POS;
+		static_assert(_LOOKUP_TABLES, "in_heap() requires lookup tables");
+		return _lookup[value].position != NON_EXISTING_POS;
 	}
-#endif
 
 	/**
 	 * Wypisywanie zawartoci poszczeglnych kubekw
 	 */
 	void dump() {
-#if USE_LOOKUP_TABLES
-		printf("zawartosc kolejki (priorytet, wartosc, miejsce):\n");
-#else
-		printf("zawartosc kolejki (priorytet, wartosc):\n")
-#endif
-			for (key_t i = 0; i < _buckets_no; ++i) {
-				printf("#%d\t", i);
-#if CACHE_MIN
-				if (_buckets_min[i] == NON_EXISTING_KEY) {
-					printf("pusto\n");
-					continue;
-				}
-#endif
-				for (position_t j = 0; j < _buckets[i].size(); ++j) {
-#if USE_LOOKUP_TABLES
-					printf("(%d, %d, %d), ", _buckets[i][j].key, _buckets[i][j].value, _element_positions[_buckets[i][j].value]);
-#else
-					printf("(%d, %d), ", _buckets[i][j].key, _buckets[i][j].value);
-#endif
-				}
-				printf("\n");
+		if (_LOOKUP_TABLES) printf("zawartosc kolejki (priorytet, wartosc, miejsce):\n");
+		else printf("zawartosc kolejki (priorytet, wartosc):\n");
+		for (size_t i = 0; i < BUCKETS_COUNT; ++i) {
+			printf("#%d\t", static_cast<int>(i));
+			if (_buckets[i].empty()) {
+				printf("pusto\n");
+				continue;
 			}
+			for (size_t j = 0; j < _buckets[i].size(); ++j) {
+				const element el = _buckets[i][j];
+				printf("(%llu, %d", static_cast<unsigned long long>(el.key), el.value);
+				if (_LOOKUP_TABLES) printf(", %d", static_cast<int>(_lookup[el.value].position) - 1);
+				printf("), ");
+			}
+			printf("\n");
+		}
 		printf("\n");
 	}
 
 private:
+	typedef std::integral_constant<bool, _LOOKUP_TABLES> _lookup_tag;
+	typedef std::integral_constant<bool, _SOA_BUCKETS> _soa_tag;
+	typedef _rebind_t<lookup_entry> _lookup_alloc_t;
+	typedef std::integral_constant<bool, std::is_trivially_copyable<value_t>::value> _trivial_value_t;
+
+	// Kubeki konstruowane od razu z alokatorem (nie musi mie konstruktora domylnego)
+	template <size_t... I>
+	static std::array<bucket_t, radix::bucket_index<key_t>::BUCKETS> _make_buckets(const allocator_t& alloc, std::index_sequence<I...>) {
+		return {{ (static_cast<void>(I), bucket_t(alloc))... }};
+	}
+
 	/**
-	 * Numer kubeka jest okrelany przez najwyszy ustawiony bit
+	 * Numer kubeka jest okrelany przez najwyszy bit rnicy klucz od ostatnio usunitej wartoci
 	 * @param key klucz (priorytet) dla szukanego elementu
 	 */
-	key_t _find_bucket(const key_t key) const {
-		if (key == _last_deleted) return 0;
-#if USE_ABM_LZCNT
-		key_t res = __lzcnt(key ^ _last_deleted);
-#else
-		unsigned long res;
-		_BitScanReverse(&res, key ^ _last_deleted);
-#endif
-		assert(res + 1 < _buckets_no);
-		return res + 1;
+	size_t _find_bucket(const key_t key) const {
+		const size_t res = index_t::find(key, _last_deleted);
+		assert(res < BUCKETS_COUNT);
+		return res;
+	}
+
+	/**
+	 * Przeniesienie najmniejszych elementw do kubeka #0 (jeli jest pusty)
+	 *
+	 * Jeli jest kilka elementw minimalnych o tej samej wartoci (priorytecie)
+	 * to redystrybucja pakuje je wszystkie do kubeka #0
+	 * wic jeli co jest w #0 mona pomin redystrybucj
+	 */
+	void _pull_least() {
+		assert(_items_count > 0);
+		// Jeli co jest w kubeku #0 to jest to minimum
+		if (!_buckets[0].empty()) return;
+
+		// Pierwszy niepusty kubeek - najniszy ustawiony bit maski
+		const size_t i = index_t::first(_occupied);
+		assert(!_buckets[i].empty());
+		_pull_bucket(i, _bucket_least(i));
+	}
+
+	// Najmniejszy priorytet w niepustym kubeku i
+	key_t _bucket_least(const size_t i) const {
+		return _CACHE_MIN ? _buckets_min.get(i) : _bucket_min(_buckets[i], _soa_tag());
+	}
+
+	// Usunity jest element o najmniejszym priorytecie (least) z kubeka i - redystrybucja kubeka
+	void _pull_bucket(const size_t i, const key_t least) {
+		_last_deleted = least;
+		if (_CACHE_MIN) _buckets_min.set(i, NON_EXISTING_KEY);
+		_redistribute(i);
+	}
+
+	/**
+	 * Obnienie ostatnio usunitej wartoci do last (wszystkie elementy s >= last) bez penej redystrybucji
+	 * Jeli stara i nowa warto rni si najwyej na bicie d, kubeek #d+1 jest pusty (klucz rnicy si
+	 * od starej wartoci najwyej na bicie d byby od niej mniejszy) - kubeki #0..#d s w caoci
+	 * dopisywane do kubeka #d+1, nic innego si nie przesuwa
+	 */
+	void _rebase(const key_t last) {
+		assert(last <= _last_deleted);
+		if (last == _last_deleted) return;
+		const size_t target = _find_bucket(last);
+		assert(_buckets[target].empty());
+
+		key_t least = NON_EXISTING_KEY;
+		for (size_t b = 0; b < target; ++b) {
+			bucket_t& src = _buckets[b];
+			if (src.empty()) continue;
+			// Minimum kubeka #0 to ostatnio usunita warto
+			least = std::min(least, b ? _buckets_min.get(b) : _last_deleted);
+			_buckets_min.set(b, NON_EXISTING_KEY);
+			const size_t from = _append(_buckets[target], src);
+			for (size_t j = from; j < _buckets[target].size(); ++j)
+				_set_position(_buckets[target][j].value, j, _lookup_tag());
+		}
+		_buckets_min.set(target, _buckets[target].empty() ? NON_EXISTING_KEY : least);
+		// Kubeki #1..#target-1 s teraz puste
+		_occupied &= ~(index_t::bit(target) | (index_t::bit(target) - 1));
+		_set_occupied(_buckets[target].empty() ? 0 : target);
+		_last_deleted = last;
+	}
+
+	/**
+	 * Przeniesienie elementw src na koniec dst (src zostaje pusty), zwraca pozycj pierwszego przeniesionego
+	 * Do pustego dst ze wsplnym alokatorem przejmowany jest bufor src - bez kopiowania
+	 */
+	static size_t _append(bucket_t& dst, bucket_t& src) {
+		const size_t from = dst.size();
+		if (!from && dst.get_allocator() == src.get_allocator()) {
+			dst.swap(src);
+			return from;
+		}
+		const size_t needed = from + src.size();
+		if (needed > dst.capacity()) dst.reserve(std::max(needed, dst.capacity() * 2));
+		for (size_t j = 0; j < src.size(); ++j) dst.push_back(std::move(src[j]));
+		src.clear();
+		return from;
+	}
+
+	// Przepisanie wpisw lookup table elementw przeniesionych z other (od pozycji from kubeka)
+	void _adopt(bucket_t& bucket, const size_t from, RadixHeap& other, std::true_type) {
+		for (size_t j = from; j < bucket.size(); ++j) {
+			const value_t& value = bucket[j].value;
+			assert(static_cast<size_t>(value) < _element_count && _lookup[value].position == NON_EXISTING_POS);
+			other._forget(value, _lookup_tag());
+			_track(value, j, bucket[j].key, _lookup_tag());
+		}
+	}
+
+	void _adopt(bucket_t&, const size_t, RadixHeap&, std::false_type) {}
+
+	/**
+	 * Redystrybucja elementw kubeka i (po ustawieniu _last_deleted)
+	 * - numery kubekw docelowych liczone s od razu dla caego kubeka (SIMD w ukadzie SoA)
+	 * - zliczenie elementw dla kadego kubeka docelowego i jednorazowa rezerwacja miejsca
+	 * - rozrzucenie elementw od koca (kolejno taka sama jak przy zdejmowaniu przez pop_back())
+	 */
+	void _redistribute(const size_t i) {
+		bucket_t& src = _buckets[i];
+		const size_t count = src.size();
+		// Mae kubeki (najczstszy przypadek) - przenoszenie element po elemencie
+		if (count < BATCH_REDISTRIBUTION) {
+			while (!src.empty()) {
+				element el = src.pop_back();
+				const size_t new_bucket = _find_bucket(el.key);
+				_buckets_min.update(new_bucket, el.key);
+				_buckets[new_bucket].push_back(std::move(el));
+				_set_occupied(new_bucket);
+				_set_position(_buckets[new_bucket].back().value, _buckets[new_bucket].size() - 1, _lookup_tag());
+			}
+			_occupied &= ~index_t::bit(i);
+			return;
+		}
+
+		_targets.resize(count);
+		_bucket_numbers(src, _targets.data(), _soa_tag());
+
+		std::array<size_t, BUCKETS_COUNT> counts = {};
+		for (size_t j = 0; j < count; ++j) ++counts[_targets[j]];
+		for (size_t b = 0; b < i; ++b) {
+			if (!counts[b]) continue;
+			// Wzrost geometryczny - kubeek moe by celem wielu kolejnych redystrybucji
+			const size_t needed = _buckets[b].size() + counts[b];
+			if (needed > _buckets[b].capacity()) _buckets[b].reserve(std::max(needed, _buckets[b].capacity() * 2));
+			_set_occupied(b);
+		}
+
+		for (size_t j = count; j-- > 0;) {
+			const size_t new_bucket = _targets[j];
+			bucket_t& dst = _buckets[new_bucket];
+			_buckets_min.update(new_bucket, src[j].key);
+			dst.push_back(std::move(src[j]));
+			// Element przenosimy na koniec nowego kubeka
+			_set_position(dst.back().value, dst.size() - 1, _lookup_tag());
+		}
+		src.clear();
+		_occupied &= ~index_t::bit(i);
+	}
+
+	/**
+	 * Podzia [0, n) na chunks fragmentw, fragment #0 wykonywany jest w biecym wtku
+	 * fn(numer fragmentu, pocztek, koniec)
+	 */
+	template <class fn_t>
+	static void _parallel_chunks(const size_t n, const unsigned chunks, const fn_t& fn) {
+		std::vector<std::thread> workers;
+		for (unsigned t = 1; t < chunks; ++t) workers.emplace_back(std::cref(fn), t, n * t / chunks, n * (t + 1) / chunks);
+		fn(0, 0, n / chunks);
+		for (std::thread& worker : workers) worker.join();
+	}
+
+	// Powikszenie kubeka przed build() - typy trywialne s zapisywane bezporednio w buforze
+	static void _grow_bucket(bucket_t& bucket, const size_t count, std::true_type) {
+		bucket.append_uninitialized(count);
+	}
+
+	static void _grow_bucket(bucket_t& bucket, const size_t count, std::false_type) {
+		bucket.reserve(bucket.size() + count);
+	}
+
+	template <class offsets_t>
+	void _scatter(const value_t* values, const key_t* keys, const size_t n, const unsigned chunks, offsets_t& offsets, std::true_type) {
+		_parallel_chunks(n, chunks, [&](const unsigned t, const size_t begin, const size_t end) {
+			std::array<size_t, BUCKETS_COUNT>& pos = offsets[t];
+			for (size_t i = begin; i < end; ++i) {
+				const size_t b = _targets[i];
+				_store(_buckets[b], pos[b], values[i], keys[i], _soa_tag());
+				_track(values[i], pos[b]++, keys[i], _lookup_tag());
+			}
+		});
+	}
+
+	template <class offsets_t>
+	void _scatter(const value_t* values, const key_t* keys, const size_t n, const unsigned, offsets_t&, std::false_type) {
+		for (size_t i = 0; i < n; ++i) {
+			bucket_t& bucket = _buckets[_targets[i]];
+			bucket.emplace_back(typename element::in_place_t(), keys[i], values[i]);
+			_track(values[i], bucket.size() - 1, keys[i], _lookup_tag());
+		}
+	}
+
+	// Zapis elementu w miejscu zarezerwowanym przez append_uninitialized()
+	static void _store(bucket_t& bucket, const size_t pos, const value_t& value, const key_t key, std::true_type) {
+		bucket.values()[pos] = value;
+		bucket.keys()[pos] = key;
+	}
+
+	static void _store(bucket_t& bucket, const size_t pos, const value_t& value, const key_t key, std::false_type) {
+		new (bucket.data() + pos) element(value, key);
+	}
+
+	// Numery kubekw docelowych - w ukadzie SoA klucze s cige, wic liczone s wektorowo
+	void _bucket_numbers(const bucket_t& src, std::uint8_t* out, std::true_type) const {
+		radix::simd::bucket_numbers(src.keys(), src.size(), _last_deleted, out);
+	}
+
+	void _bucket_numbers(const bucket_t& src, std::uint8_t* out, std::false_type) const {
+		for (size_t j = 0; j < src.size(); ++j) out[j] = static_cast<std::uint8_t>(_find_bucket(src[j].key));
+	}
+
+	/**
+	 * Minimum kluczy w kubeku (NON_EXISTING_KEY dla pustego) - skanowanie wektorowe
+	 * W ukadzie AoS klucze s przeplecione z wartociami, kernel pomija wtedy co drugie sowo
+	 */
+	static key_t _bucket_min(const bucket_t& bucket, std::true_type) {
+		return radix::simd::min_key(bucket.keys(), bucket.size());
+	}
+
+	static key_t _bucket_min(const bucket_t& bucket, std::false_type) {
+		return radix::simd::min_key(bucket.data(), bucket.size(), &element::key);
+	}
+
+	// Usunicie elementw kubeka (i ich wpisw w lookup table) bez zwalniania pamici
+	void _reset_bucket(const size_t bucket_no) {
+		bucket_t& bucket = _buckets[bucket_no];
+		if (_LOOKUP_TABLES)
+			for (size_t j = 0; j < bucket.size(); ++j) _forget(bucket[j].value, _lookup_tag());
+		bucket.clear();
+	}
+
+	/**
+	 * Aktualizacja maski niepustych kubekw (kubeek #0 nie ma swojego bitu)
+	 */
+	void _set_occupied(const size_t bucket_no) {
+		if (bucket_no) _occupied |= index_t::bit(bucket_no);
+	}
+
+	void _clear_if_empty(const size_t bucket_no) {
+		if (bucket_no && _buckets[bucket_no].empty()) _occupied &= ~index_t::bit(bucket_no);
+	}
+
+	/**
+	 * Aktualizacja lookup table - przy wyczonej lookup table wersje bez efektu
+	 * (value_t nie musi wtedy by liczb cakowit)
+	 */
+	void _track(const value_t& value, const size_t pos, const key_t key, std::true_type) {
+		lookup_entry& entry = _lookup[value];
+		entry.position = _position(pos);
+		entry.key = key;
+	}
+
+	void _track(const value_t&, const size_t, const key_t, std::false_type) {}
+
+	void _set_position(const value_t& value, const size_t pos, std::true_type) {
+		_lookup[value].position = _position(pos);
+	}
+
+	void _set_position(const value_t&, const size_t, std::false_type) {}
+
+	void _forget(const value_t& value, std::true_type) {
+		_lookup[value] = lookup_entry();
+	}
+
+	void _forget(const value_t&, std::false_type) {}
+
+	// Pozycja w kubeku zakodowana w rekordzie (+1) i zawona do position_t (kubeek nie moe przekroczy zakresu typu)
+	static position_t _position(const size_t pos) {
+		assert(pos < std::numeric_limits<position_t>::max());
+		return static_cast<position_t>(pos + 1);
+	}
+
+	/**
+	 * Alokacja wyzerowanej lookup table
+	 * Alokatory z allocate_zeroed() (domylny - calloc(), huge_page_allocator - mmap): due bloki pochodz
+	 * bezporednio z mmap/VirtualAlloc i s zerowane przez system przy pierwszym dotkniciu strony, wic
+	 * konstrukcja nie zaley od element_count, a zajta pami fizyczna od iloci faktycznie uytych wartoci
+	 * Inne alokatory (np. arena) - zwyka alokacja i memset()
+	 */
+	lookup_entry* _allocate_lookup(std::true_type) {
+		return _lookup_alloc.allocate_zeroed(_element_count);
+	}
+
+	lookup_entry* _allocate_lookup(std::false_type) {
+		lookup_entry *res = std::allocator_traits<_lookup_alloc_t>::allocate(_lookup_alloc, _element_count);
+		std::memset(res, 0, _element_count * sizeof(lookup_entry));
+		return res;
+	}
+
+	/**
+	 * Przeniesienie caego kubeka #0 (elementy minimalne) na koniec bufora _batch
+	 * Pusty bufor jest po prostu zamieniany z kubekiem (pojemno przechodzi na kubeek)
+	 */
+	void _take_least() {
+		const size_t from = _append(_batch, _buckets[0]);
+		_items_count -= _batch.size() - from;
+		if (_LOOKUP_TABLES)
+			for (size_t j = from; j < _batch.size(); ++j) _forget(_batch[j].value, _lookup_tag());
 	}
 
 	/**
 	 * Usunicie najmniejszego elementu z kolejki i zwrcenie go
 	 * Zwraca najmniejszy element (wczeniej umieszczony w kubeku #0)
 	 */
-	element& _remove_least() {
+	element _remove_least() {
 		assert(_items_count > 0);
 		// Zwrcenie elementu najmniejszego - zawsze w zerowym kubeku
 		--_items_count;
-		element& least = _buckets[0].pop_back();
-#if USE_LOOKUP_TABLES
+		element least = _buckets[0].pop_back();
 		// Usunicie z lookup table
-		_element_positions[least.value] = NON_EXISTING_POS;
-		_current_priorities[least.value] = NON_EXISTING_KEY;
-#endif
+		_forget(least.value, _lookup_tag());
 		return least;
 	}
 
-#if CACHE_MIN && USE_LOOKUP_TABLES
 	/**
-	 * Szukanie nowego minimum dla okrelonego kubeka
+	 * Szukanie nowego minimum dla okrelonego kubeka (CACHE_MIN)
 	 * Jeli usunita warto nie bya minimum w kubeku, funkcja nic nie robi
 	 * Jeli po zmianie priorytetu warto zostaje w kubeku, sprawdzanie jest pominite
 	 *
@@ -330,51 +848,59 @@ private:
 	 * @param old_key usunita warto
 	 * @param old_key nowy priorytet dla wartoci
 	 */
-	void _fix_minimum(const key_t bucket_no, const key_t old_key, const key_t new_key) {
-		if (_buckets_min[bucket_no] != old_key || _find_bucket(old_key) == _find_bucket(new_key))
+	void _fix_minimum(const size_t bucket_no, const key_t old_key, const key_t new_key) {
+		if (_buckets_min.get(bucket_no) != old_key || _find_bucket(old_key) == _find_bucket(new_key))
 			return;
-		// Poprzednie minimum dla tego kubeka
-		const key_t old_min = _buckets_min[bucket_no];
-		_buckets_min[bucket_no] = NON_EXISTING_KEY;
-		for (position_t i = 0; i < _buckets[bucket_no].size(); ++i) {
-			// Mamy kilka elementw minimalnych
-			if (old_min == _buckets[bucket_no][i].key) {
-				_buckets_min[bucket_no] = old_min;
-				return;
-			}
-			_buckets_min[bucket_no] = element::min(_buckets_min[bucket_no], _buckets[bucket_no][i].key);
-		}
+		// Pene skanowanie (SIMD) zamiast ptli z wczesnym wyjciem - jeli jest kilka elementw
+		// minimalnych, wynik i tak jest rwny poprzedniemu minimum
+		_buckets_min.set(bucket_no, _bucket_min(_buckets[bucket_no], _soa_tag()));
 	}
-#endif
+
+	typedef radix::bucket_index<key_t> index_t;
+	typedef typename index_t::mask_t mask_t;
 
 	// Maksymalna warto klucza/priorytetu
-	static const key_t MAX_PRIORITY = UINT_MAX;
+	static const key_t MAX_PRIORITY = std::numeric_limits<key_t>::max();
+	// Ilo kubekw - jeden na kady bit klucza + kubeek #0
+	static const size_t BUCKETS_COUNT = radix::bucket_index<key_t>::BUCKETS;
+	// Od jakiej wielkoci kubeka redystrybucja jest robiona wsadowo (numery kubekw dla caego kubeka naraz)
+	static const size_t BATCH_REDISTRIBUTION = 64;
+	// Minimalna ilo elementw na wtek w build()
+	static const size_t PARALLEL_BUILD = 1 << 16;
 	// Warto oznaczajca nieistniejcy klucz (priorytet)
 	static const key_t NON_EXISTING_KEY = std::numeric_limits<key_t>::max();
-#if USE_LOOKUP_TABLES
-	// Warto oznaczajca nieistniejc pozycj (nie ma w kolejce)
-	static const position_t NON_EXISTING_POS = std::numeric_limits<position_t>::max();
-#endif
+	// Zakodowana pozycja oznaczajca brak w kolejce (rekord lookup table z samych zer)
+	static const position_t NON_EXISTING_POS = 0;
 
-	// Kubeki i dane z nimi zwizane
-	key_t _buckets_no;
 	// Ostatnio usunita warto
 	key_t _last_deleted;
 	// Ilo elementw w kolejce
 	size_t _items_count;
-	bucket_t* _buckets = nullptr;
-#if CACHE_MIN
-	// Minima dla poszczeglnych kubekw
-	key_t* _buckets_min = nullptr;
-#endif
+	// Maska niepustych kubekw #1..#n - szukanie kubeka w pop() to jedna instrukcja
+	mask_t _occupied;
+	// Bufor na numery kubekw docelowych przy redystrybucji
+	vector<std::uint8_t, false, allocator_t> _targets;
+	// Kubeki i dane z nimi zwizane - trzymane bezporednio w obiekcie, bez dodatkowej alokacji
+	std::array<bucket_t, BUCKETS_COUNT> _buckets;
+	// Wynik pop_min_batch()/pop_until()
+	bucket_t _batch;
+	// Minima dla poszczeglnych kubekw (CACHE_MIN)
+	radix::detail::bucket_minima<_CACHE_MIN, key_t, BUCKETS_COUNT> _buckets_min;
 
-#if USE_LOOKUP_TABLES
-	// Lookup table dla wyszukiwania w reduce_priority
-	position_t* _element_positions = nullptr;
-	// Wielko lookup table
-	position_t _element_count;
-
-	// Cachowane priorytety dla poszczeglnych wartoci
-	key_t* _current_priorities;
-#endif
+	// Alokator lookup table
+	_lookup_alloc_t _lookup_alloc;
+	// Lookup table dla wyszukiwania w reduce_priority - pozycje i cachowane priorytety wartoci
+	lookup_entry* _lookup = nullptr;
+	// Wielko lookup table (0 bez lookup table)
+	size_t _element_count;
 };
+
+// Definicje staych (wymagane, gdy s przekazywane przez referencj, np. do std::min/fill)
+template <class value_t, class key_t, class position_t, class policy_t, class allocator_t>
+const key_t RadixHeap<value_t, key_t, position_t, policy_t, allocator_t>::MAX_PRIORITY;
+template <class value_t, class key_t, class position_t, class policy_t, class allocator_t>
+const size_t RadixHeap<value_t, key_t, position_t, policy_t, allocator_t>::BUCKETS_COUNT;
+template <class value_t, class key_t, class position_t, class policy_t, class allocator_t>
+const key_t RadixHeap<value_t, key_t, position_t, policy_t, allocator_t>::NON_EXISTING_KEY;
+template <class value_t, class key_t, class position_t, class policy_t, class allocator_t>
+const position_t RadixHeap<value_t, key_t, position_t, policy_t, allocator_t>::NON_EXISTING_POS;
@@ -2,53 +2,109 @@
 
 #include <vector>
 #include <array>
+#include <cassert>
 #include <cstddef>
 #include <limits>
-#include <map>
 #include <type_traits>
+#include <utility>
+#include <algorithm>
+#include "bucket_index.h"
+#include "lookup_index.h"
+#include "simd.h"
 
 namespace radix {
 	/**
-	 * Radix heap
+	 * Radix heap - wsplna implementacja dla queue i lookup_queue
+	 * Zamiast metod wirtualnych uywany jest CRTP: klasa pochodna (derived_t) dostarcza hooki
+	 * wywoywane dla kadego elementu, ktre s rozwizywane w czasie kompilacji i si inline'uj:
+	 *	- _on_placed(element, pos) - nowy element trafi na pozycj pos kubeka (push)
+	 *	- _on_moved(element, pos) - element przeniesiony na pozycj pos innego kubeka (redystrybucja)
+	 *	- _on_removed(element) - element zosta zdjty z kolejki
 	 *
 	 * Wymagania:
-	 *	- klucz jest intem
+	 *	- klucz jest liczb cakowit bez znaku (float/liczby ze znakiem - radix::mapped_queue, key_traits.h)
 	 *	- elementy wrzucane s nie mniejsze ni ostatni usunity element
 	 */
-	template <
-		class value_t,
-		class key_t = unsigned,
-		class bucket_t = std::vector<std::pair<value_t, key_t>>
-	>
-	class queue {
-		static_assert(std::is_integral<key_t>::value, "Key must be integer type");
+	template <class derived_t, class value_t, class key_t, class bucket_t>
+	class queue_base {
+		static_assert(std::is_integral<key_t>::value && std::is_unsigned<key_t>::value,
+			"Key must be unsigned integer type (use radix::mapped_queue for float/signed keys)");
 	public:
 		typedef std::pair<value_t, key_t> element_t;
 
-		queue() : _items_count(0), _last_deleted(0) {
-			for (size_t i = 0; i < _buckets_min.size(); ++i) _buckets_min[i] = MAX_PRIORITY;
+		queue_base() : _last_deleted(0), _items_count(0), _occupied(0) {
+			_buckets_min.fill(NON_EXISTING_KEY);
 		}
 
-		virtual element_t& pop() {
-			if (!_buckets[0].empty()) return _remove_least();
-
-			size_t i = 0;
-			for (; _buckets[i].empty(); ++i);
-
-			_last_deleted = _buckets_min[i];
-			_buckets_min[i] = MAX_PRIORITY;
-
-			while (!_buckets[i].empty()) _redistribute_bucket(i);
-
+		/**
+		 * Usuwanie minimum z kolejki
+		 * Zwraca (przez warto) najmniejszy element w kolejce
+		 */
+		element_t pop() {
+			_pull_least();
 			return _remove_least();
 		}
 
-		virtual void push(const value_t& item, const key_t key) {
+		/**
+		 * Podgld najmniejszego elementu bez usuwania go z kolejki
+		 * Referencja jest wana do nastpnej operacji modyfikujcej kolejk
+		 */
+		const element_t& top() {
+			_pull_least();
+			return _buckets[0].back();
+		}
+
+		void push(const value_t& item, const key_t key) {
+			assert(key >= _last_deleted);
 			++_items_count;
 
-			const key_t bucket = _find_bucket(key);
+			const size_t bucket = _find_bucket(key);
 			_buckets[bucket].emplace_back(item, key);
 			_buckets_min[bucket] = std::min(_buckets_min[bucket], key);
+			_set_occupied(bucket);
+			_derived()._on_placed(_buckets[bucket].back(), _buckets[bucket].size() - 1);
+		}
+
+		/**
+		 * Oprnienie kolejki do ponownego uycia - koszt O(size()) (hook _on_removed tylko dla
+		 * pozostaych elementw), kubeki zachowuj zaalokowan pami
+		 */
+		void reset() {
+			for (bucket_t& bucket : _buckets) {
+				for (const element_t& el : bucket) _derived()._on_removed(el);
+				bucket.clear();
+			}
+			_last_deleted = 0;
+			_items_count = 0;
+			_occupied = 0;
+			_buckets_min.fill(NON_EXISTING_KEY);
+		}
+
+		/**
+		 * Scalenie z inn kolejk - wszystkie elementy other trafiaj do tej kolejki, other zostaje pusta
+		 * Obie kolejki s sprowadzane do mniejszej z ostatnio usunitych wartoci (_rebase()), po czym
+		 * kubeki o tych samych numerach s czone parami (pusty kubeek przejmuje bufor kubeka other)
+		 * Hooki: _on_removed w other i _on_placed w tej kolejce - tylko dla przeniesionych elementw
+		 */
+		void merge(derived_t& other) {
+			assert(this != &other);
+			const key_t last = std::min(_last_deleted, other._last_deleted);
+			_rebase(last);
+			other._rebase(last);
+			for (size_t b = 0; b < BUCKETS_COUNT; ++b) {
+				bucket_t& src = other._buckets[b];
+				if (src.empty()) continue;
+				_buckets_min[b] = std::min(_buckets_min[b], other._buckets_min[b]);
+				bucket_t& dst = _buckets[b];
+				const size_t from = _append(dst, src);
+				_set_occupied(b);
+				for (size_t j = from; j < dst.size(); ++j) {
+					other._on_removed(dst[j]);
+					_derived()._on_placed(dst[j], j);
+				}
+			}
+			_items_count += other._items_count;
+			other.reset();
 		}
 
 		size_t size() const {
@@ -59,31 +115,107 @@ namespace radix {
 			return _items_count == 0;
 		}
 	protected:
-		key_t _find_bucket(const key_t key) const {
-			if (key == _last_deleted) return 0;
-			// @todo: gcc version
-			return 1;// __lzcnt(key ^ _last_deleted);
+		derived_t& _derived() {
+			return static_cast<derived_t&>(*this);
+		}
+
+		size_t _find_bucket(const key_t key) const {
+			return index_t::find(key, _last_deleted);
+		}
+
+		void _set_occupied(const size_t bucket) {
+			if (bucket) _occupied |= index_t::bit(bucket);
+		}
+
+		void _clear_if_empty(const size_t bucket) {
+			if (bucket && _buckets[bucket].empty()) _occupied &= ~index_t::bit(bucket);
+		}
+
+		// Przeniesienie najmniejszych elementw do kubeka #0 (jeli jest pusty)
+		void _pull_least() {
+			assert(_items_count > 0);
+			if (!_buckets[0].empty()) return;
+
+			// Pierwszy niepusty kubeek - najniszy ustawiony bit maski
+			const size_t i = index_t::first(_occupied);
+
+			_last_deleted = _buckets_min[i];
+			_buckets_min[i] = NON_EXISTING_KEY;
+
+			// Rozrzucenie elementw od koca, kubeek jest czyszczony na koniec (bez pop_back() dla kadego)
+			bucket_t& src = _buckets[i];
+			for (size_t j = src.size(); j-- > 0;) {
+				const size_t new_bucket = _find_bucket(src[j].second);
+				bucket_t& dst = _buckets[new_bucket];
+				_buckets_min[new_bucket] = std::min(_buckets_min[new_bucket], src[j].second);
+				dst.push_back(std::move(src[j]));
+				_set_occupied(new_bucket);
+				_derived()._on_moved(dst.back(), dst.size() - 1);
+			}
+			src.clear();
+			_occupied &= ~index_t::bit(i);
+		}
+
+		/**
+		 * Obnienie ostatnio usunitej wartoci do last (wszystkie elementy s >= last)
+		 * Jeli stara i nowa warto rni si najwyej na bicie d, kubeek #d+1 jest pusty, a kubeki #0..#d
+		 * s w caoci dopisywane do kubeka #d+1 - nic innego si nie przesuwa
+		 */
+		void _rebase(const key_t last) {
+			assert(last <= _last_deleted);
+			if (last == _last_deleted) return;
+			const size_t target = _find_bucket(last);
+			bucket_t& dst = _buckets[target];
+			assert(dst.empty());
+
+			key_t least = NON_EXISTING_KEY;
+			for (size_t b = 0; b < target; ++b) {
+				if (_buckets[b].empty()) continue;
+				// Minimum kubeka #0 to ostatnio usunita warto
+				least = std::min(least, b ? _buckets_min[b] : _last_deleted);
+				_buckets_min[b] = NON_EXISTING_KEY;
+				const size_t from = _append(dst, _buckets[b]);
+				for (size_t j = from; j < dst.size(); ++j) _derived()._on_moved(dst[j], j);
+			}
+			_buckets_min[target] = dst.empty() ? NON_EXISTING_KEY : least;
+			_occupied &= ~(index_t::bit(target) | (index_t::bit(target) - 1));
+			if (!dst.empty()) _set_occupied(target);
+			_last_deleted = last;
 		}
 
-		virtual element_t& _remove_least() {
+		// Przeniesienie elementw src na koniec dst (src zostaje pusty), zwraca pozycj pierwszego przeniesionego
+		static size_t _append(bucket_t& dst, bucket_t& src) {
+			const size_t from = dst.size();
+			if (!from && dst.get_allocator() == src.get_allocator()) {
+				dst.swap(src);
+				return from;
+			}
+			const size_t needed = from + src.size();
+			if (needed > dst.capacity()) dst.reserve(std::max(needed, dst.capacity() * 2));
+			for (size_t j = 0; j < src.size(); ++j) dst.push_back(std::move(src[j]));
+			src.clear();
+			return from;
+		}
+
+		element_t _remove_least() {
 			--_items_count;
-			element_t& least = _buckets[0].back();
+			element_t least = std::move(_buckets[0].back());
 			_buckets[0].pop_back();
+			_derived()._on_removed(least);
 			return least;
 		}
 
-		virtual key_t _redistribute_bucket(const size_t i) {
-			const element_t& el = _buckets[i].back();
-			const key_t new_bucket = _find_bucket(el.second);
-			_buckets[i].pop_back();
-			_buckets[new_bucket].emplace_back(el.first, el.second);
-			_buckets_min[new_bucket] = std::min(_buckets_min[new_bucket], el.second);
-
-			return new_bucket;
+		// Ponowne wyznaczenie minimum kubeka (skanowanie wektorowe, pary 8-bajtowe - co drugie sowo)
+		void _fix_minimum(const size_t bucket_no) {
+			const bucket_t& bucket = _buckets[bucket_no];
+			_buckets_min[bucket_no] = simd::min_key(bucket.data(), bucket.size(), &element_t::second);
 		}
 
+		typedef bucket_index<key_t> index_t;
+		typedef typename index_t::mask_t mask_t;
+
 		// Ilo kubekw
-		static const size_t BUCKETS_COUNT = 32;
+		static const size_t BUCKETS_COUNT = bucket_index<key_t>::BUCKETS;
 		// Maksymalna warto klucza/priorytetu
 		static const key_t MAX_PRIORITY = std::numeric_limits<key_t>::max();
 		// Warto oznaczajca nieistniejcy klucz (priorytet)
@@ -93,86 +225,131 @@ namespace radix {
 		key_t _last_deleted;
 		// Ilo elementw w kolejce
 		size_t _items_count;
+		// Maska niepustych kubekw #1..#n
+		mask_t _occupied;
 		std::array<bucket_t, BUCKETS_COUNT> _buckets;
 		std::array<key_t, BUCKETS_COUNT> _buckets_min;
 	};
 
+	template <class derived_t, class value_t, class key_t, class bucket_t>
+	const size_t queue_base<derived_t, value_t, key_t, bucket_t>::BUCKETS_COUNT;
+	template <class derived_t, class value_t, class key_t, class bucket_t>
+	const key_t queue_base<derived_t, value_t, key_t, bucket_t>::MAX_PRIORITY;
+	template <class derived_t, class value_t, class key_t, class bucket_t>
+	const key_t queue_base<derived_t, value_t, key_t, bucket_t>::NON_EXISTING_KEY;
+
+	/**
+	 * Radix heap bez zmiany priorytetu - hooki s puste i znikaj po inline'owaniu
+	 */
+	template <
+		class value_t,
+		class key_t = unsigned,
+		class bucket_t = std::vector<std::pair<value_t, key_t>>
+	>
+	class queue : public queue_base<queue<value_t, key_t, bucket_t>, value_t, key_t, bucket_t> {
+		typedef queue_base<queue, value_t, key_t, bucket_t> parent_t;
+		friend parent_t;
+	public:
+		typedef typename parent_t::element_t element_t;
+
+		queue() {}
+		// Dla zgodnoci API z lookup_queue/RadixHeap (ilo elementw nie jest potrzebna)
+		explicit queue(const size_t) {}
+	protected:
+		void _on_placed(const element_t&, const size_t) {}
+		void _on_moved(const element_t&, const size_t) {}
+		void _on_removed(const element_t&) {}
+	};
+
 	/**
 	 * Radix heap wykorzystujcy lookup table
 	 * Potencjalnie szybsza wersja przy wykorzystaniu dla alg. Dijkstry
 	 * Przy okazji pozwala na zmian priorytetu elementw bdcych w kolejce
-	 *
-	 * @todo: lepiej by byo chyba trzyma map dla kadego kubeka osobno (?)
+	 * Pooenie elementw trzymane jest w indeksie lookup_t (lookup_index.h):
+	 *	- hash_lookup (domylnie) - dowolne identyfikatory, np. 64-bitowe hasze
+	 *	- dense_lookup - identyfikatory 0..n-1, np. numery wierzchokw
 	 *
 	 * Wymagania:
 	 *	- klucz jest intem
 	 *	- elementy wrzucane s nie mniejsze ni ostatni usunity element
 	 *  - wartoci (nie klucze!) s unikalne
 	 */
-	 // Wersja wykorzystujca lookup table
 	template <
 		class value_t,
 		class key_t = unsigned,
-		class bucket_t = std::vector<std::pair<value_t, key_t>>
+		class bucket_t = std::vector<std::pair<value_t, key_t>>,
+		class lookup_t = hash_lookup<value_t, key_t>
 	>
-	class lookup_queue : public queue<value_t, key_t, bucket_t> {
-		typedef queue<value_t, key_t, bucket_t> parent_t;
-		typedef std::pair<size_t, key_t> _pos_prio_t;
-		typedef typename parent_t::element_t element_t;
+	class lookup_queue : public queue_base<lookup_queue<value_t, key_t, bucket_t, lookup_t>, value_t, key_t, bucket_t> {
+		typedef queue_base<lookup_queue, value_t, key_t, bucket_t> parent_t;
+		typedef typename lookup_t::record_t record_t;
+		friend parent_t;
 	public:
-		virtual void push(const value_t& item, const key_t key) {
-			parent_t::push(item, key);
-			const key_t bucket = _find_bucket(key);
-			_pos_prio[item] = _pos_prio_t(this->_buckets[bucket].size() - 1, key);
-		}
+		typedef typename parent_t::element_t element_t;
 
+		/**
+		 * @param capacity przewidywana ilo elementw - indeks jest alokowany od razu
+		 */
+		explicit lookup_queue(const size_t capacity = 0) : _lookup(capacity) {}
+
+		/**
+		 * Zmiana priorytetu elementu bdcego w kolejce
+		 * Nowy priorytet moe by mniejszy lub wikszy od starego, ale nie mniejszy ni ostatnio usunity
+		 *
+		 * @param item warto dla ktrej ma by zmieniony priorytet
+		 * @param new_key nowy priorytet dla elementu
+		 */
 		void change_priority(const value_t& item, const key_t new_key) {
-			// Poprzednie dane elementu
-			const _pos_prio_t& prev_pos_prio = _pos_prio[item];
-			const key_t old_key = prev_pos_prio.second;
-			const size_t item_pos = prev_pos_prio.first;
-			const bucket_t& bucket = this->_buckets[_find_bucket(prev_pos_prio.second)];
+			record_t* record = _lookup.find(item);
+			assert(record && new_key >= this->_last_deleted);
+			const key_t old_key = record->key;
+			const size_t item_pos = record->position;
+			const size_t bucket_no = this->_find_bucket(old_key);
+			bucket_t& bucket = this->_buckets[bucket_no];
+
+			// Element zostaje w tym samym kubeku - zmiana w miejscu
+			if (bucket_no == this->_find_bucket(new_key)) {
+				bucket[item_pos].second = new_key;
+				record->key = new_key;
+				if (new_key < this->_buckets_min[bucket_no]) this->_buckets_min[bucket_no] = new_key;
+				else if (old_key == this->_buckets_min[bucket_no] && new_key > old_key) this->_fix_minimum(bucket_no);
+				return;
+			}
+
+			// Usunicie ze rodka kubeka - ostatni element przenoszony jest na zwolnione miejsce
 			if (item_pos != bucket.size() - 1) {
-				_pos_prio[bucket.back().first].first = item_pos;
-				std::swap(bucket[item_pos], this->_buckets[bucket].back());
+				bucket[item_pos] = std::move(bucket.back());
+				_lookup.at(bucket[item_pos].first).position = record->position;
 			}
 			bucket.pop_back();
+			this->_clear_if_empty(bucket_no);
+			if (old_key == this->_buckets_min[bucket_no]) this->_fix_minimum(bucket_no);
+
+			// Dodanie elementu jeszcze raz (rekord w indeksie jest nadpisywany)
+			--this->_items_count;
+			this->push(item, new_key);
 		}
 
 		bool in_heap(const value_t& item) const {
-			return _pos_prio.find(item) != _pos_prio.end();
+			return _lookup.contains(item);
 		}
 	protected:
-		virtual key_t _redistribute_bucket(const size_t i) {
-			const element_t& el = this->_buckets[i].back();
-			const key_t new_bucket = _redistribute_bucket(i);
-			_pos_prio[el.first].first = this->_buckets[new_bucket].size() - 1;
+		void _on_placed(const element_t& el, const size_t pos) {
+			record_t& record = _lookup.insert(el.first);
+			assert(pos < record_t::NON_EXISTING_POS);
+			record.position = static_cast<decltype(record_t::position)>(pos);
+			record.key = el.second;
 		}
 
-		void _fix_minimum(const key_t bucket_no, const key_t old_key, const key_t new_key) {
-			if (this->_buckets_min[bucket_no] != old_key || _find_bucket(old_key) == _find_bucket(new_key))
-				return;
-			const key_t old_min = this->_buckets_min[bucket_no];
-			this->_buckets_min[bucket_no] = this->MAX_PRIORITY;
-			const bucket_t& bucket = this->_buckets[bucket_no];
-			for (size_t i = 0; i < bucket.size(); ++i) {
-				if (old_min == bucket[i].second) {
-					this->_buckets_min[bucket_no] = old_min;
-					return;
-				}
-				this->_buckets_min[bucket_no] = std::min(this->_buckets_min[bucket_no], bucket[i].second);
-			}
+		void _on_moved(const element_t& el, const size_t pos) {
+			assert(pos < record_t::NON_EXISTING_POS);
+			_lookup.at(el.first).position = static_cast<decltype(record_t::position)>(pos);
 		}
 
-		virtual element_t& _remove_least() {
-			const element_t& least = parent_t::_remove_least();
-			_pos_prio[least.first] = _pos_prio_t(NON_EXISTING_POS, this->NON_EXISTING_KEY);
-			return least;
+		void _on_removed(const element_t& el) {
+			_lookup.erase(el.first);
 		}
 
-		std::map<value_t, _pos_prio_t> _pos_prio;
-		static const size_t NON_EXISTING_POS = std::numeric_limits<size_t>::max();
+		lookup_t _lookup;
 	};
-
-	// @todo: wersja lookup z tablic zamiast mapy (?)
-}
\ No newline at end of file
+}
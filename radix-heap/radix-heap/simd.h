@@ -0,0 +1,318 @@
+#pragma once
+
+#include "cpu.h"
+#include "bucket_index.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if RADIX_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * Kernele SIMD dla operacji na kluczach caego kubeka
+ * Wersja (AVX2/SSE4.1/skalarna) jest wybierana w runtime na podstawie CPU, wic kod nie wymaga
+ * kompilacji z -mavx2 (/arch:AVX2)
+ */
+namespace radix {
+	namespace simd {
+		/**
+		 * Numery kubekw docelowych dla n kluczy - wersja skalarna (dowolna szeroko klucza)
+		 *
+		 * @param keys klucze
+		 * @param n ilo kluczy
+		 * @param last_deleted ostatnio usunita warto
+		 * @param out bufor na n numerw kubekw
+		 */
+		template <class key_t>
+		void bucket_numbers_scalar(const key_t* keys, const size_t n, const key_t last_deleted, std::uint8_t* out) {
+			for (size_t i = 0; i < n; ++i)
+				out[i] = static_cast<std::uint8_t>(bucket_index<key_t>::find(keys[i], last_deleted));
+		}
+
+#if RADIX_X86
+		/**
+		 * Numer najwyszego bitu liczony przez konwersj na float i odczyt wykadnika:
+		 * - x & ~(x >> 1) zostawia najwyszy bit i nie ma dwch ssiednich jedynek, wic konwersja
+		 *   nie zaokrgli wyniku w gr do kolejnej potgi 2
+		 * - konwersja jest ze znakiem, dlatego bit 31 (kubeek #32) jest obsugiwany osobno
+		 * - kubeek = max(wykadnik - 126, 0), dla x == 0 wykadnik jest zerowy, czyli kubeek #0
+		 */
+		RADIX_TARGET("avx2")
+		inline void bucket_numbers_avx2(const std::uint32_t* keys, const size_t n, const std::uint32_t last_deleted, std::uint8_t* out) {
+			const __m256i last = _mm256_set1_epi32(static_cast<int>(last_deleted));
+			const __m256i exp_mask = _mm256_set1_epi32(0xFF);
+			const __m256i bias = _mm256_set1_epi32(126);
+			const __m256i top_bucket = _mm256_set1_epi32(32);
+			const __m256i zero = _mm256_setzero_si256();
+
+			size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				__m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), last);
+				const __m256i high = _mm256_srai_epi32(x, 31);
+				x = _mm256_andnot_si256(_mm256_srli_epi32(x, 1), x);
+				__m256i res = _mm256_and_si256(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(x)), 23), exp_mask);
+				res = _mm256_max_epi32(_mm256_sub_epi32(res, bias), zero);
+				res = _mm256_blendv_epi8(res, top_bucket, high);
+
+				// 8 x 32 bity -> 8 x 8 bitw
+				const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(res), _mm256_extracti128_si256(res, 1));
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(words, words));
+			}
+			bucket_numbers_scalar(keys + i, n - i, last_deleted, out + i);
+		}
+
+		RADIX_TARGET("sse4.1")
+		inline void bucket_numbers_sse41(const std::uint32_t* keys, const size_t n, const std::uint32_t last_deleted, std::uint8_t* out) {
+			const __m128i last = _mm_set1_epi32(static_cast<int>(last_deleted));
+			const __m128i exp_mask = _mm_set1_epi32(0xFF);
+			const __m128i bias = _mm_set1_epi32(126);
+			const __m128i top_bucket = _mm_set1_epi32(32);
+			const __m128i zero = _mm_setzero_si128();
+
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				__m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), last);
+				const __m128i high = _mm_srai_epi32(x, 31);
+				x = _mm_andnot_si128(_mm_srli_epi32(x, 1), x);
+				__m128i res = _mm_and_si128(_mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(x)), 23), exp_mask);
+				res = _mm_max_epi32(_mm_sub_epi32(res, bias), zero);
+				res = _mm_blendv_epi8(res, top_bucket, high);
+
+				const __m128i words = _mm_packus_epi32(res, res);
+				const int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+				out[i] = static_cast<std::uint8_t>(bytes);
+				out[i + 1] = static_cast<std::uint8_t>(bytes >> 8);
+				out[i + 2] = static_cast<std::uint8_t>(bytes >> 16);
+				out[i + 3] = static_cast<std::uint8_t>(bytes >> 24);
+			}
+			bucket_numbers_scalar(keys + i, n - i, last_deleted, out + i);
+		}
+#endif
+
+		// Dowolne klucze - wersja skalarna
+		template <class key_t>
+		void bucket_numbers(const key_t* keys, const size_t n, const key_t last_deleted, std::uint8_t* out) {
+			bucket_numbers_scalar(keys, n, last_deleted, out);
+		}
+
+		// Klucze 32-bitowe - wersja wektorowa, jeli CPU j obsuguje
+		inline void bucket_numbers(const std::uint32_t* keys, const size_t n, const std::uint32_t last_deleted, std::uint8_t* out) {
+#if RADIX_X86
+			if (cpu::features<>::avx2) return bucket_numbers_avx2(keys, n, last_deleted, out);
+			if (cpu::features<>::sse41) return bucket_numbers_sse41(keys, n, last_deleted, out);
+#endif
+			bucket_numbers_scalar(keys, n, last_deleted, out);
+		}
+
+		/**
+		 * Minimum 32-bitowych sw - wersja skalarna
+		 * Sowa o parzystych indeksach s OR-owane z even_mask, co pozwala pomin wartoci przeplecione
+		 * z kluczami (tablica par (warto, klucz) - even_mask = ~0) bez osobnego kernela
+		 *
+		 * @param words sowa
+		 * @param n ilo sw
+		 * @param even_mask maska dla sw o parzystych indeksach (0 dla cigej tablicy kluczy)
+		 */
+		inline std::uint32_t min_u32_scalar(const std::uint32_t* words, const size_t n, const std::uint32_t even_mask) {
+			std::uint32_t res = std::numeric_limits<std::uint32_t>::max();
+			for (size_t i = 0; i < n; ++i) {
+				const std::uint32_t w = words[i] | ((i & 1) ? 0 : even_mask);
+				if (w < res) res = w;
+			}
+			return res;
+		}
+
+#if RADIX_X86
+		// Kernele przetwarzaj parzyst ilo sw na iteracj, wic parzysto indeksw w ogonie si zgadza
+		RADIX_TARGET("avx512f")
+		inline std::uint32_t min_u32_avx512(const std::uint32_t* words, const size_t n, const std::uint32_t even_mask) {
+			const __m512i mask = _mm512_set1_epi64(static_cast<long long>(even_mask));
+			__m512i acc = _mm512_set1_epi32(-1);
+			size_t i = 0;
+			for (; i + 16 <= n; i += 16)
+				acc = _mm512_min_epu32(acc, _mm512_or_si512(_mm512_loadu_si512(words + i), mask));
+			const std::uint32_t res = static_cast<std::uint32_t>(_mm512_reduce_min_epu32(acc));
+			const std::uint32_t tail = min_u32_scalar(words + i, n - i, even_mask);
+			return res < tail ? res : tail;
+		}
+
+		RADIX_TARGET("avx2")
+		inline std::uint32_t min_u32_avx2(const std::uint32_t* words, const size_t n, const std::uint32_t even_mask) {
+			const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(even_mask));
+			// Dwa niezalene akumulatory - min_epu32 ma opnienie 1, ale przepustowo 2/takt
+			__m256i acc0 = _mm256_set1_epi32(-1), acc1 = acc0;
+			size_t i = 0;
+			for (; i + 16 <= n; i += 16) {
+				acc0 = _mm256_min_epu32(acc0, _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i)), mask));
+				acc1 = _mm256_min_epu32(acc1, _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i + 8)), mask));
+			}
+			acc0 = _mm256_min_epu32(acc0, acc1);
+			__m128i acc = _mm_min_epu32(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1));
+			acc = _mm_min_epu32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+			acc = _mm_min_epu32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+			const std::uint32_t res = static_cast<std::uint32_t>(_mm_cvtsi128_si32(acc));
+			const std::uint32_t tail = min_u32_scalar(words + i, n - i, even_mask);
+			return res < tail ? res : tail;
+		}
+
+		/**
+		 * SSE2 nie ma porwnania liczb bez znaku - po odwrceniu najwyszego bitu porwnanie ze znakiem
+		 * daje ten sam wynik, minimum wybierane jest mask z _mm_cmpgt_epi32
+		 */
+		inline std::uint32_t min_u32_sse2(const std::uint32_t* words, const size_t n, const std::uint32_t even_mask) {
+			const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+			const __m128i mask = _mm_set_epi32(0, static_cast<int>(even_mask), 0, static_cast<int>(even_mask));
+			// Akumulator trzymany jest z odwrconym bitem znaku
+			__m128i acc = _mm_set1_epi32(0x7FFFFFFF);
+			size_t i = 0;
+			for (; i + 4 <= n; i += 4) {
+				const __m128i x = _mm_xor_si128(_mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i)), mask), sign);
+				const __m128i gt = _mm_cmpgt_epi32(acc, x);
+				acc = _mm_or_si128(_mm_and_si128(gt, x), _mm_andnot_si128(gt, acc));
+			}
+			alignas(16) std::uint32_t lanes[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(acc, sign));
+			std::uint32_t res = min_u32_scalar(words + i, n - i, even_mask);
+			for (int l = 0; l < 4; ++l)
+				if (lanes[l] < res) res = lanes[l];
+			return res;
+		}
+#endif
+
+		// Minimum 32-bitowych sw - najszerszy zestaw instrukcji obsugiwany przez CPU
+		inline std::uint32_t min_u32(const std::uint32_t* words, const size_t n, const std::uint32_t even_mask) {
+#if RADIX_X86
+			if (cpu::features<>::avx512) return min_u32_avx512(words, n, even_mask);
+			if (cpu::features<>::avx2) return min_u32_avx2(words, n, even_mask);
+			return min_u32_sse2(words, n, even_mask);
+#else
+			return min_u32_scalar(words, n, even_mask);
+#endif
+		}
+
+		/**
+		 * Minimum cigej tablicy kluczy (ukad SoA), dla n == 0 maksymalna warto klucza
+		 * Dowolne klucze - wersja skalarna, klucze 32-bitowe - wersja wektorowa
+		 */
+		template <class key_t>
+		key_t min_key(const key_t* keys, const size_t n) {
+			key_t res = std::numeric_limits<key_t>::max();
+			for (size_t i = 0; i < n; ++i)
+				if (keys[i] < res) res = keys[i];
+			return res;
+		}
+
+		inline std::uint32_t min_key(const std::uint32_t* keys, const size_t n) {
+			return min_u32(keys, n, 0);
+		}
+
+		// Wersja skalarna i wersja dla elementw 8-bajtowych (wybierane w min_key poniej)
+		template <class element_t, class key_t>
+		key_t min_key(const element_t* data, const size_t n, key_t element_t::* key, std::false_type) {
+			key_t res = std::numeric_limits<key_t>::max();
+			for (size_t i = 0; i < n; ++i)
+				if (data[i].*key < res) res = data[i].*key;
+			return res;
+		}
+
+		template <class element_t, class key_t>
+		key_t min_key(const element_t* data, const size_t n, key_t element_t::* key, std::true_type) {
+			if (n == 0) return std::numeric_limits<key_t>::max();
+			// Klucz musi by drugim sowem elementu (pierwsze sowo jest maskowane)
+			if (reinterpret_cast<const char*>(&(data->*key)) - reinterpret_cast<const char*>(data) == 4)
+				return min_u32(reinterpret_cast<const std::uint32_t*>(data), 2 * n, ~0u);
+			return min_key(data, n, key, std::false_type());
+		}
+
+		/**
+		 * Minimum kluczy w tablicy elementw (ukad AoS), dla n == 0 maksymalna warto klucza
+		 * Elementy 8-bajtowe z 32-bitowym kluczem w drugiej poowie (np. std::pair<unsigned, unsigned>)
+		 * traktowane s jako tablica sw z pomijaniem co drugiego, pozostae - skalarnie
+		 *
+		 * @param data elementy
+		 * @param n ilo elementw
+		 * @param key wskanik na pole klucza w elemencie
+		 */
+		template <class element_t, class key_t>
+		key_t min_key(const element_t* data, const size_t n, key_t element_t::* key) {
+			typedef std::integral_constant<bool, sizeof(element_t) == 8 && std::is_same<key_t, std::uint32_t>::value &&
+				std::is_standard_layout<element_t>::value> packed_t;
+			return min_key(data, n, key, packed_t());
+		}
+
+		/**
+		 * Indeks najmniejszego z n kluczy (pierwszy przy remisie) - wybr dziecka w kopcu d-arnym
+		 * Wersja skalarna (dowolne n)
+		 */
+		template <unsigned n>
+		unsigned min_index_scalar(const std::uint32_t* keys) {
+			unsigned res = 0;
+			for (unsigned i = 1; i < n; ++i)
+				if (keys[i] < keys[res]) res = i;
+			return res;
+		}
+
+#if RADIX_X86
+		/**
+		 * Minimum rozgaszane na wszystkie pozycje rejestru, porwnanie z kluczami i najniszy bit maski wyniku
+		 * (najniszy indeks przy remisie, jak w wersji skalarnej)
+		 */
+		RADIX_TARGET("avx2")
+		inline __m256i broadcast_min_avx2(__m256i x) {
+			x = _mm256_min_epu32(x, _mm256_permute2x128_si256(x, x, 1));
+			x = _mm256_min_epu32(x, _mm256_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+			return _mm256_min_epu32(x, _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+		}
+
+		RADIX_TARGET("avx2")
+		inline unsigned min_index8_avx2(const std::uint32_t* keys) {
+			const __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+			const __m256i eq = _mm256_cmpeq_epi32(k, broadcast_min_avx2(k));
+			return detail::lsb32(static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(eq))));
+		}
+
+		RADIX_TARGET("avx2")
+		inline unsigned min_index16_avx2(const std::uint32_t* keys) {
+			const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+			const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + 8));
+			const __m256i least = broadcast_min_avx2(_mm256_min_epu32(low, high));
+			const unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(low, least))))
+				| static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(high, least)))) << 8;
+			return detail::lsb32(mask);
+		}
+
+		RADIX_TARGET("avx512f")
+		inline unsigned min_index16_avx512(const std::uint32_t* keys) {
+			const __m512i k = _mm512_loadu_si512(keys);
+			const __m512i least = _mm512_set1_epi32(static_cast<int>(_mm512_reduce_min_epu32(k)));
+			return detail::lsb32(static_cast<std::uint32_t>(_mm512_cmpeq_epu32_mask(k, least)));
+		}
+#endif
+
+		// Indeks najmniejszego z n kluczy - dla 8 i 16 kluczy wersja wektorowa, jeli CPU j obsuguje
+		template <unsigned n>
+		unsigned min_index(const std::uint32_t* keys) {
+			return min_index_scalar<n>(keys);
+		}
+
+		template <>
+		inline unsigned min_index<8>(const std::uint32_t* keys) {
+#if RADIX_X86
+			if (cpu::features<>::avx2) return min_index8_avx2(keys);
+#endif
+			return min_index_scalar<8>(keys);
+		}
+
+		template <>
+		inline unsigned min_index<16>(const std::uint32_t* keys) {
+#if RADIX_X86
+			if (cpu::features<>::avx512) return min_index16_avx512(keys);
+			if (cpu::features<>::avx2) return min_index16_avx2(keys);
+#endif
+			return min_index_scalar<16>(keys);
+		}
+	}
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "radix.h"
+#include "key_traits.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace radix {
+	/**
+	 * Strumieniowe sortowanie kluczy schematem kubekw radix heap ("sorted drain")
+	 * Klucze wrzucane s w dowolnej kolejnoci (nie mniejsze ni ostatnio wypisany), drain_until() wypisuje
+	 * posortowane wszystkie klucze <= granicy - np. dla strumienia znacznikw czasu z ograniczonym opnieniem
+	 * granica to najwikszy dotd klucz - opnienie, a w kubekach zostaje tylko "okno" niewypisanych kluczy
+	 * - kubeki zawieraj same klucze (bez wartoci i lookup table), minima kubekw aktualizowane przy wstawianiu,
+	 *   wic sprawdzenie granicy przy kadym wywoaniu drain_until() nie przeglda kubeka
+	 * - klucze rwne ostatnio wypisanemu s tylko liczone (kubeek #0 to licznik)
+	 * - klucze float/double/ze znakiem przez key_traits (kodowane przy wstawianiu, dekodowane przy wypisywaniu)
+	 *
+	 * Wymagania:
+	 *	- klucze wrzucane s nie mniejsze ni ostatnio wypisany
+	 *	- kolejne granice drain_until() s niemalejce
+	 */
+	template <class key_t, class allocator_t = malloc_allocator<char>>
+	class sorted_drain {
+		typedef key_traits<key_t> traits_t;
+	public:
+		typedef typename traits_t::bits_t bits_t;
+		typedef vector<bits_t, false, typename std::allocator_traits<allocator_t>::template rebind_alloc<bits_t>> bucket_t;
+
+		explicit sorted_drain(const allocator_t& alloc = allocator_t())
+			: _buckets(_make_buckets(alloc, std::make_index_sequence<index_t::BUCKETS>())) {
+			_min.fill(std::numeric_limits<bits_t>::max());
+		}
+
+		sorted_drain(const sorted_drain&) = delete;
+		sorted_drain& operator=(const sorted_drain&) = delete;
+
+		// Wstawienie klucza
+		void push(const key_t key) {
+			const bits_t bits = traits_t::encode(key);
+			assert(bits >= _last);
+			++_items_count;
+			if (bits == _last) ++_equal;
+			else _place(bits, index_t::find(bits, _last));
+		}
+
+		/**
+		 * Przesunicie ostatnio wypisanego klucza na dolne ograniczenie kolejnych kluczy (tylko przy pustej kolejce)
+		 * Klucze bliej ostatnio wypisanego trafiaj do niszych kubekw - mniej redystrybucji,
+		 * np. przy sortowaniu znacznikw czasu z duym wsplnym przedrostkiem
+		 */
+		void start_at(const key_t lower_bound) {
+			assert(empty());
+			_last = traits_t::encode(lower_bound);
+		}
+
+		// Wstawienie zakresu kluczy
+		template <class InputIt>
+		void push(InputIt first, const InputIt last) {
+			for (; first != last; ++first) push(*first);
+		}
+
+		/**
+		 * Wypisanie (w kolejnoci niemalejcej) wszystkich kluczy <= bound
+		 * Zwraca iterator za ostatnim wypisanym kluczem
+		 */
+		template <class OutputIt>
+		OutputIt drain_until(const key_t bound, OutputIt out) {
+			return _drain(traits_t::encode(bound), out);
+		}
+
+		// Wypisanie wszystkich kluczy
+		template <class OutputIt>
+		OutputIt drain(OutputIt out) {
+			return _drain(std::numeric_limits<bits_t>::max(), out);
+		}
+
+		// Ilo niewypisanych kluczy
+		size_t size() const {
+			return _items_count;
+		}
+
+		bool empty() const {
+			return _items_count == 0;
+		}
+
+		// Oprnienie do ponownego uycia - kubeki zachowuj zaalokowan pami
+		void reset() {
+			for (mask_t mask = _occupied; mask; mask &= mask - 1) {
+				_buckets[index_t::first(mask)].clear();
+				_min[index_t::first(mask)] = std::numeric_limits<bits_t>::max();
+			}
+			_occupied = 0;
+			_equal = 0;
+			_items_count = 0;
+			_last = 0;
+		}
+
+	private:
+		typedef bucket_index<bits_t> index_t;
+		typedef typename index_t::mask_t mask_t;
+
+		template <size_t... I>
+		static std::array<bucket_t, index_t::BUCKETS> _make_buckets(const allocator_t& alloc, std::index_sequence<I...>) {
+			return {{ (static_cast<void>(I), bucket_t(alloc))... }};
+		}
+
+		void _place(const bits_t bits, const size_t bucket) {
+			_buckets[bucket].push_back(bits);
+			_occupied |= index_t::bit(bucket);
+			if (bits < _min[bucket]) _min[bucket] = bits;
+		}
+
+		/**
+		 * Wypisywanie kluczy <= limit (zakodowanych)
+		 * Klucze rwne ostatnio wypisanemu id od razu na wyjcie, potem pierwszy niepusty kubeek
+		 * jest redystrybuowany wzgldem swojego minimum (o ile nie przekracza ono granicy)
+		 */
+		template <class OutputIt>
+		OutputIt _drain(const bits_t limit, OutputIt out) {
+			for (;;) {
+				if (_equal) {
+					if (_last > limit) break;
+					out = std::fill_n(out, _equal, traits_t::decode(_last));
+					_items_count -= _equal;
+					_equal = 0;
+				}
+				if (!_occupied) break;
+
+				const size_t i = index_t::first(_occupied);
+				const bits_t least = _min[i];
+				if (least > limit) break;
+
+				// Elementy kubeka #i trafiaj do kubekw < i (albo do licznika rwnych minimum)
+				_last = least;
+				bucket_t& src = _buckets[i];
+				_min[i] = std::numeric_limits<bits_t>::max();
+				for (const bits_t bits : src) {
+					if (bits == least) ++_equal;
+					else _place(bits, index_t::find(bits, least));
+				}
+				src.clear();
+				_occupied &= ~index_t::bit(i);
+			}
+			return out;
+		}
+
+		// Ostatnio wypisany klucz (zakodowany) i ilo wrzuconych kluczy mu rwnych
+		bits_t _last = 0;
+		size_t _equal = 0;
+		size_t _items_count = 0;
+		// Maska niepustych kubekw #1..#BITS
+		mask_t _occupied = 0;
+		// Minima kubekw (pusty kubeek - maksymalna warto)
+		std::array<bits_t, index_t::BUCKETS> _min;
+		std::array<bucket_t, index_t::BUCKETS> _buckets;
+	};
+
+	/**
+	 * Sortowanie kluczy (bez wartoci) przez sorted_drain - wynik w out (n elementw)
+	 * Kubeki liczone wzgldem minimum wejcia, wic opacalne dla kluczy o maym rozrzucie wzgldem minimum
+	 * (np. znaczniki czasu z jednego okresu)
+	 */
+	template <class key_t>
+	void radix_heap_sort(const key_t* keys, const size_t n, key_t* out) {
+		if (!n) return;
+		sorted_drain<key_t> drain;
+		drain.start_at(*std::min_element(keys, keys + n));
+		drain.push(keys, keys + n);
+		drain.drain(out);
+	}
+
+	/**
+	 * Wersja strumieniowa - klucze z iteratora wejciowego, wynik przez iterator wyjciowy
+	 * Zwraca iterator za ostatnim wypisanym kluczem
+	 */
+	template <class InputIt, class OutputIt>
+	OutputIt radix_heap_sort(InputIt first, const InputIt last, OutputIt out) {
+		sorted_drain<typename std::iterator_traits<InputIt>::value_type> drain;
+		drain.push(first, last);
+		return drain.drain(out);
+	}
+
+	namespace detail {
+		// Klucze dla RadixHeap::build() - bez kopiowania, jeli kodowanie jest tosamoci
+		template <class key_t>
+		const key_bits_t<key_t>* encoded_keys(const key_t* keys, const size_t, std::vector<key_bits_t<key_t>>&, std::true_type) {
+			return keys;
+		}
+
+		template <class key_t>
+		const key_bits_t<key_t>* encoded_keys(const key_t* keys, const size_t n, std::vector<key_bits_t<key_t>>& tmp, std::false_type) {
+			tmp.resize(n);
+			std::transform(keys, keys + n, tmp.begin(), &key_traits<key_t>::encode);
+			return tmp.data();
+		}
+	}
+
+	/**
+	 * Sortowanie par (klucz, warto) - RadixHeap bez lookup table, wczytanie przez build(),
+	 * a zdejmowanie caymi grupami rwnych kluczy (pop_min_batch()) prosto do tablic wynikowych
+	 * Sortowanie nie jest stabilne (kolejno wartoci o rwnych kluczach nie jest zachowana)
+	 *
+	 * @param keys klucze
+	 * @param values wartoci
+	 * @param n ilo elementw
+	 * @param out_keys posortowane klucze (n elementw)
+	 * @param out_values wartoci w kolejnoci kluczy (n elementw)
+	 */
+	template <class key_t, class value_t>
+	void radix_heap_sort(const key_t* keys, const value_t* values, const size_t n, key_t* out_keys, value_t* out_values) {
+		typedef key_bits_t<key_t> bits_t;
+		std::vector<bits_t> tmp;
+		RadixHeap<value_t, bits_t, std::uint32_t, lean_policy> heap;
+		heap.build(values, detail::encoded_keys(keys, n, tmp, std::is_same<key_t, bits_t>()), n);
+		while (!heap.empty()) {
+			for (const auto& el : heap.pop_min_batch()) {
+				*out_keys++ = key_traits<key_t>::decode(el.key);
+				*out_values++ = el.value;
+			}
+		}
+	}
+}
@@ -6,7 +6,23 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/range/irange.hpp>
 #include <vector>
+#include <algorithm>
+#include <cstdint>
 #include "radix.h"
+#include "dijkstra.h"
+#include "dial.h"
+#include "multilevel.h"
+#include "key_traits.h"
+#include "sort.h"
+#include "lookup_index.h"
+#include "huge_pages.h"
+#include <map>
+#include <set>
+#include <queue>
+#include <random>
+#include <iterator>
+#include <list>
+#include <string>
 
 typedef RadixHeap<unsigned, unsigned> rheap;
 typedef std::pair<unsigned, unsigned> iipair;
@@ -302,6 +318,38 @@ BOOST_FIXTURE_TEST_CASE(Change_Last1_Bucket_After_Redist, basic_fixture)
 	BOOST_TEST(expected == keys_res, boost::test_tools::per_element());
 }
 
+// Podgld minimum nie zmienia zawartoci kolejki
+BOOST_FIXTURE_TEST_CASE(Top_Element, basic_fixture)
+{
+	BOOST_CHECK_EQUAL(heap->top().key, 7);
+	BOOST_CHECK_EQUAL(heap->top().value, 0);
+	BOOST_CHECK_EQUAL(heap->size(), n.size());
+
+	heap->pop();
+	BOOST_CHECK_EQUAL(heap->top().key, 8);
+	BOOST_CHECK_EQUAL(heap->top().value, 4);
+
+	_pop_keys_from_heap();
+	iv expected = { 8,9,10,11,13,16,23,30,33,39,48,49,51,57,58,59,63 };
+	BOOST_TEST(expected == keys_res, boost::test_tools::per_element());
+}
+
+// Zwrcony element nie moe by nadpisany przez kolejne operacje na kolejce
+BOOST_FIXTURE_TEST_CASE(Pop_Returns_Copy, basic_fixture)
+{
+	const auto first = heap->pop();
+	heap->emplace(7, 0xF0);
+	heap->push(0xF1, 7);
+	BOOST_CHECK_EQUAL(first.value, 0);
+	BOOST_CHECK_EQUAL(first.key, 7);
+
+	const auto second = heap->pop();
+	BOOST_CHECK_EQUAL(second.key, 7);
+	BOOST_CHECK_EQUAL(heap->pop().key, 7);
+	BOOST_CHECK_EQUAL(heap->pop().key, 8);
+	BOOST_CHECK_EQUAL(second.key, 7);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 ///////////////////////////////////////////////////////////////////////////////////
 BOOST_AUTO_TEST_SUITE(Big_Data)
@@ -364,6 +412,158 @@ BOOST_AUTO_TEST_CASE(Push_Pop_50k_reverse)
 	BOOST_TEST(src == res);
 }
 
+/**
+ * Losowe klucze i losowe redukcje priorytetu przeplatane z pop()
+ * Kubeki s wielokrotnie oprniane i zapeniane
+ */
+BOOST_AUTO_TEST_CASE(Random_Operations_20k)
+{
+	const unsigned COUNT = 20 * 1000;
+	std::mt19937 gen(7);
+	std::uniform_int_distribution<unsigned> dis(0, 1 << 20);
+	rheap heap(COUNT);
+	std::vector<unsigned> keys(COUNT);
+	for (unsigned i = 0; i < COUNT; ++i) heap.push(i, keys[i] = dis(gen));
+
+	unsigned last = 0;
+	while (!heap.empty()) {
+		const auto el = heap.pop();
+		BOOST_REQUIRE_EQUAL(el.key, keys[el.value]);
+		BOOST_REQUIRE_LE(last, el.key);
+		last = el.key;
+		// Kilka redukcji priorytetu - nie poniej ostatnio zdjtej wartoci
+		for (int j = 0; j < 3; ++j) {
+			const unsigned v = dis(gen) % COUNT;
+			if (!heap.in_heap(v) || keys[v] == last) continue;
+			keys[v] = last + (keys[v] - last) / 2;
+			heap.reduce_priority(v, keys[v]);
+		}
+	}
+}
+
+/**
+ * Dua przestrze identyfikatorw, z ktrej uywany jest uamek - lookup table nie jest inicjalizowana
+ * (rekord z samych zer to brak w kolejce), wic nie jest te w caoci zajmowana
+ */
+BOOST_AUTO_TEST_CASE(Sparse_Ids_In_Huge_Lookup_Table)
+{
+	const unsigned IDS = 1u << 26;
+	rheap heap(IDS);
+	for (unsigned i = 0; i < 1000; ++i) BOOST_REQUIRE(!heap.in_heap(i * 40503u % IDS));
+	for (unsigned i = 0; i < 1000; ++i) heap.push(i * 65521u % IDS, 5000 - i);
+	BOOST_CHECK(heap.in_heap(65521u));
+	BOOST_CHECK(!heap.in_heap(65520u));
+	heap.reduce_priority(65521u, 0);
+	const auto first = heap.pop();
+	BOOST_CHECK_EQUAL(first.value, 65521u);
+	BOOST_CHECK_EQUAL(first.key, 0);
+	BOOST_CHECK(!heap.in_heap(65521u));
+	BOOST_CHECK_EQUAL(heap.pop().key, 4001);
+}
+
+/**
+ * build() na kilku wtkach do niepustej kolejki (po redystrybucji) - wynik jak dla push()
+ */
+BOOST_AUTO_TEST_CASE(Build_300k)
+{
+	const unsigned COUNT = 300 * 1000, PUSHED = 1000;
+	std::mt19937 gen(21);
+	std::vector<unsigned> values(COUNT), keys(COUNT);
+	for (unsigned i = 0; i < COUNT; ++i) {
+		values[i] = i;
+		keys[i] = 1000 + gen() % (1 << 24);
+	}
+	rheap heap(COUNT);
+	for (unsigned i = 0; i < PUSHED; ++i) heap.push(values[i], keys[i] = i);
+	for (unsigned i = 0; i < 10; ++i) BOOST_REQUIRE_EQUAL(heap.pop().key, i);
+
+	heap.build(values.data() + PUSHED, keys.data() + PUSHED, COUNT - PUSHED, 4);
+	BOOST_CHECK_EQUAL(heap.size(), COUNT - 10);
+	for (unsigned i = PUSHED; i < COUNT; i += 100) {
+		BOOST_REQUIRE(heap.in_heap(i));
+		heap.reduce_priority(i, keys[i] -= keys[i] % 1000);
+	}
+
+	std::vector<unsigned> expected(keys.begin() + 10, keys.end()), res;
+	std::sort(expected.begin(), expected.end());
+	while (!heap.empty()) {
+		const auto el = heap.pop();
+		BOOST_REQUIRE_EQUAL(el.key, keys[el.value]);
+		res.push_back(el.key);
+	}
+	BOOST_TEST(res == expected, boost::test_tools::per_element());
+
+	// Wartoci nietrywialne (bez lookup table) - zapis przez emplace_back()
+	RadixHeap<std::string, unsigned, std::uint32_t, radix::lean_policy> strings;
+	const std::string names[] = { "c", "a", "b", "d" };
+	const unsigned name_keys[] = { 30, 10, 20, 40 };
+	strings.build(names, name_keys, 4);
+	BOOST_CHECK_EQUAL(strings.pop().value, "a");
+	BOOST_CHECK_EQUAL(strings.pop().value, "b");
+	BOOST_CHECK_EQUAL(strings.size(), 2);
+}
+
+/**
+ * reset() w poowie zdejmowania - kolejka po resecie zachowuje si jak nowa
+ * (lookup table wyczyszczona take dla elementw, ktre zostay w kubekach)
+ */
+BOOST_AUTO_TEST_CASE(Reset_Reuse)
+{
+	const unsigned COUNT = 10 * 1000;
+	std::mt19937 gen(5);
+	rheap heap(COUNT);
+	for (unsigned query = 0; query < 3; ++query) {
+		BOOST_REQUIRE(heap.empty());
+		for (unsigned i = 0; i < COUNT; ++i) heap.push(i, gen() % 100000);
+		for (unsigned i = 0; i < COUNT / 2; ++i) heap.pop();
+		heap.reset();
+		BOOST_CHECK_EQUAL(heap.size(), 0);
+		for (unsigned i = 0; i < COUNT; ++i) BOOST_REQUIRE(!heap.in_heap(i));
+	}
+
+	// Ostatnio usunita warto te jest zerowana - mona wrzuca klucze mniejsze ni przed resetem
+	for (unsigned i = 0; i < 100; ++i) heap.push(i, 100 - i);
+	heap.reduce_priority(0, 0);
+	iv res;
+	while (!heap.empty()) res.push_back(heap.pop().key);
+	BOOST_CHECK(std::is_sorted(res.begin(), res.end()));
+	BOOST_CHECK_EQUAL(res.front(), 0);
+	BOOST_CHECK_EQUAL(res.size(), 100);
+}
+
+/**
+ * merge() kolejek o rnych ostatnio usunitych wartociach (obie kolejki s sprowadzane do mniejszej)
+ * - wartoci parzyste w jednej, nieparzyste w drugiej; po scaleniu lookup table obejmuje wszystkie
+ */
+BOOST_AUTO_TEST_CASE(Merge_20k)
+{
+	const unsigned COUNT = 20 * 1000;
+	std::mt19937 gen(11);
+	rheap a(COUNT), b(COUNT);
+	std::multiset<unsigned> expected;
+	for (unsigned i = 0; i < COUNT; ++i) (i % 2 ? b : a).push(i, 1000 + gen() % 100000);
+	for (unsigned i = 0; i < 500; ++i) a.pop();
+	for (unsigned i = 0; i < 3000; ++i) b.pop();
+	// W a zostay klucze mniejsze ni ostatnio usunity w b - cz kubekw b musi zosta przeniesiona
+	a.merge(b);
+	BOOST_CHECK(b.empty());
+	BOOST_CHECK_EQUAL(a.size(), COUNT - 500 - 3000);
+	for (unsigned i = 0; i < COUNT; ++i) BOOST_REQUIRE(!b.in_heap(i));
+
+	// Zmiana priorytetu wartoci z obu kolejek po scaleniu
+	const unsigned least = a.top().key;
+	for (unsigned i = 1; i < COUNT; i += 97)
+		if (a.in_heap(i)) a.reduce_priority(i, least);
+	iv res;
+	while (!a.empty()) res.push_back(a.pop().key);
+	BOOST_CHECK(std::is_sorted(res.begin(), res.end()));
+	BOOST_CHECK_EQUAL(res.size(), COUNT - 500 - 3000);
+
+	// Oprniona kolejka dziaa dalej
+	b.push(1, 5);
+	BOOST_CHECK_EQUAL(b.pop().value, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 ///////////////////////////////////////////////////////////////////////////////////
 BOOST_AUTO_TEST_SUITE(Same_Priorities)
@@ -460,5 +660,1088 @@ BOOST_FIXTURE_TEST_CASE(Reduce_Priority, recurring_fixture)
 	BOOST_TEST(expected == keys_res, boost::test_tools::per_element());
 }
 
+// Grupy elementw o tym samym priorytecie zdejmowane naraz
+BOOST_FIXTURE_TEST_CASE(Pop_Min_Batch, recurring_fixture)
+{
+	std::vector<iv> groups;
+	while (!heap->empty()) {
+		const rheap::bucket_t& batch = heap->pop_min_batch();
+		iv values;
+		for (size_t i = 0; i < batch.size(); ++i) {
+			BOOST_CHECK_EQUAL(batch[i].key, batch[0].key);
+			BOOST_CHECK(!heap->in_heap(batch[i].value));
+			values.push_back(batch[i].value);
+		}
+		std::sort(values.begin(), values.end());
+		groups.push_back(values);
+	}
+	const std::vector<iv> expected = { { 0, 1 }, { 4 }, { 6 }, { 2, 3, 5 }, { 7, 9 }, { 8 }, { 10, 11, 12, 13 }, { 14 } };
+	BOOST_CHECK(groups == expected);
+}
+
+BOOST_FIXTURE_TEST_CASE(Pop_Until, recurring_fixture)
+{
+	const rheap::bucket_t& batch = heap->pop_until(13);
+	BOOST_CHECK_EQUAL(batch.size(), 7);
+	for (size_t i = 1; i < batch.size(); ++i) BOOST_CHECK_LE(batch[i - 1].key, batch[i].key);
+	BOOST_CHECK_EQUAL(batch[6].key, 13);
+	BOOST_CHECK_EQUAL(heap->size(), n.size() - 7);
+
+	// Elementy wrzucone w trakcie przetwarzania wyniku nie trafiaj do niego
+	heap->push(0, 13);
+	BOOST_CHECK_EQUAL(batch.size(), 7);
+	BOOST_CHECK_EQUAL(heap->pop_until(16).size(), 3);
+	BOOST_CHECK_EQUAL(heap->pop_until(20).size(), 0);
+	_pop_keys_from_heap();
+	iv expected = { 30,39,39,39,39,63 };
+	BOOST_TEST(expected == keys_res, boost::test_tools::per_element());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(Bucket_Index)
+
+/**
+ * Numeracja kubekw musi by taka sama niezalenie od szerokoci klucza i instrukcji (LZCNT/BSR)
+ */
+template <class key_t>
+void check_bucket_numbers() {
+	typedef radix::bucket_index<key_t> index_t;
+	BOOST_CHECK_EQUAL(index_t::BUCKETS, sizeof(key_t) * 8 + 1);
+	BOOST_CHECK_EQUAL(index_t::find(7, 7), 0);
+	BOOST_CHECK_EQUAL(index_t::find(7, 0), 3);
+	BOOST_CHECK_EQUAL(index_t::find(8, 11), 2);
+	BOOST_CHECK_EQUAL(index_t::find(1, 0), 1);
+	const key_t max = std::numeric_limits<key_t>::max();
+	BOOST_CHECK_EQUAL(index_t::find(max, 0), index_t::BUCKETS - 1);
+}
+
+BOOST_AUTO_TEST_CASE(Key_Widths)
+{
+	check_bucket_numbers<std::uint8_t>();
+	check_bucket_numbers<std::uint16_t>();
+	check_bucket_numbers<std::uint32_t>();
+	check_bucket_numbers<std::uint64_t>();
+}
+
+/**
+ * Kernele SIMD musz dawa te same numery kubekw co wersja skalarna
+ */
+BOOST_AUTO_TEST_CASE(Simd_Bucket_Numbers)
+{
+	std::mt19937 gen(3);
+	std::uniform_int_distribution<unsigned> dis;
+	std::vector<unsigned> keys(1003);
+	for (auto& key : keys) key = dis(gen) >> (dis(gen) % 32);
+	keys[0] = 0xFFFFFFFF;
+	keys[1] = 0x80000001;
+	keys[2] = 0x00FFFFFF;
+	keys[3] = 0;
+
+	for (unsigned last : { 0u, 1u, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFFu, keys[10] }) {
+		std::vector<std::uint8_t> expected(keys.size()), res(keys.size());
+		radix::simd::bucket_numbers_scalar(keys.data(), keys.size(), last, expected.data());
+		radix::simd::bucket_numbers(keys.data(), keys.size(), last, res.data());
+		BOOST_TEST(expected == res, boost::test_tools::per_element());
+#if RADIX_X86
+		if (radix::cpu::features<>::sse41) {
+			radix::simd::bucket_numbers_sse41(keys.data(), keys.size(), last, res.data());
+			BOOST_TEST(expected == res, boost::test_tools::per_element());
+		}
+		if (radix::cpu::features<>::avx2) {
+			radix::simd::bucket_numbers_avx2(keys.data(), keys.size(), last, res.data());
+			BOOST_TEST(expected == res, boost::test_tools::per_element());
+		}
+#endif
+	}
+}
+
+/**
+ * Minimum kubeka - kernele SIMD (cige klucze i pary z przeplecionymi wartociami) zgodne ze skalarnym
+ */
+BOOST_AUTO_TEST_CASE(Simd_Min_Key)
+{
+	std::mt19937 gen(5);
+	std::uniform_int_distribution<unsigned> dis;
+	for (size_t n : { 0u, 1u, 7u, 16u, 33u, 1000u }) {
+		std::vector<std::pair<unsigned, unsigned>> pairs(n);
+		std::vector<unsigned> keys(n);
+		unsigned expected = 0xFFFFFFFF;
+		for (size_t i = 0; i < n; ++i) {
+			// Wartoci mniejsze od kluczy - musz zosta pominite
+			keys[i] = pairs[i].second = 0x80000000u | dis(gen);
+			pairs[i].first = i % 3;
+			expected = std::min(expected, keys[i]);
+		}
+		BOOST_TEST(radix::simd::min_key(keys.data(), n) == expected);
+		BOOST_TEST(radix::simd::min_key(pairs.data(), n, &std::pair<unsigned, unsigned>::second) == expected);
+		const std::uint32_t* words = reinterpret_cast<const std::uint32_t*>(pairs.data());
+		BOOST_TEST(radix::simd::min_u32_scalar(words, 2 * n, ~0u) == expected);
+#if RADIX_X86
+		BOOST_TEST(radix::simd::min_u32_sse2(keys.data(), n, 0) == expected);
+		BOOST_TEST(radix::simd::min_u32_sse2(words, 2 * n, ~0u) == expected);
+		if (radix::cpu::features<>::avx2) {
+			BOOST_TEST(radix::simd::min_u32_avx2(keys.data(), n, 0) == expected);
+			BOOST_TEST(radix::simd::min_u32_avx2(words, 2 * n, ~0u) == expected);
+		}
+		if (radix::cpu::features<>::avx512) {
+			BOOST_TEST(radix::simd::min_u32_avx512(keys.data(), n, 0) == expected);
+			BOOST_TEST(radix::simd::min_u32_avx512(words, 2 * n, ~0u) == expected);
+		}
+#endif
+	}
+}
+
+/**
+ * Indeks najmniejszego klucza w grupie dzieci - przy remisie najniszy
+ */
+BOOST_AUTO_TEST_CASE(Simd_Min_Index)
+{
+	std::mt19937 gen(9);
+	for (unsigned round = 0; round < 1000; ++round) {
+		alignas(64) std::uint32_t keys[16];
+		// May zakres - czste remisy
+		for (std::uint32_t& key : keys) key = round % 2 ? gen() % 4 : 0xFFFFFFF0u + gen() % 16;
+		const unsigned expected8 = radix::simd::min_index_scalar<8>(keys), expected16 = radix::simd::min_index_scalar<16>(keys);
+		BOOST_REQUIRE_EQUAL(radix::simd::min_index<8>(keys), expected8);
+		BOOST_REQUIRE_EQUAL(radix::simd::min_index<16>(keys), expected16);
+#if RADIX_X86
+		if (radix::cpu::features<>::avx2) {
+			BOOST_REQUIRE_EQUAL(radix::simd::min_index8_avx2(keys), expected8);
+			BOOST_REQUIRE_EQUAL(radix::simd::min_index16_avx2(keys), expected16);
+		}
+		if (radix::cpu::features<>::avx512) BOOST_REQUIRE_EQUAL(radix::simd::min_index16_avx512(keys), expected16);
+#endif
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(Key_Types)
+
+/**
+ * Klucze 64-bitowe - wartoci przekraczajce zakres 32 bitw
+ */
+BOOST_AUTO_TEST_CASE(Push_Pop_64bit_Keys)
+{
+	typedef RadixHeap<unsigned, std::uint64_t> heap_t;
+	const std::uint64_t BASE = 1ull << 40;
+	heap_t heap(0xFF);
+	for (unsigned i = 0; i < 50; ++i) heap.push(i, BASE + (50 - i) * (1ull << 33));
+	heap.push(50, 3);
+	heap.reduce_priority(10, BASE + 1);
+
+	std::vector<std::uint64_t> res;
+	while (!heap.empty()) res.push_back(heap.pop().key);
+	BOOST_CHECK_EQUAL(res.size(), 51);
+	BOOST_CHECK_EQUAL(res[0], 3);
+	BOOST_CHECK_EQUAL(res[1], BASE + 1);
+	BOOST_CHECK(std::is_sorted(res.begin(), res.end()));
+}
+
+/**
+ * Wsze klucze - mniej kubekw, peen zakres klucza nadal obsugiwany
+ */
+BOOST_AUTO_TEST_CASE(Push_Pop_Narrow_Keys)
+{
+	RadixHeap<unsigned, std::uint8_t> heap8(0xFF);
+	RadixHeap<unsigned, std::uint16_t> heap16(0xFF);
+	for (unsigned i = 0; i < 0xFF; ++i) {
+		heap8.push(i, static_cast<std::uint8_t>(0xFF - i));
+		heap16.push(i, static_cast<std::uint16_t>((0xFF - i) * 0xFF));
+	}
+
+	iv res8, res16;
+	while (!heap8.empty()) res8.push_back(heap8.pop().key);
+	while (!heap16.empty()) res16.push_back(heap16.pop().key);
+	BOOST_CHECK_EQUAL(res8.size(), 0xFF);
+	BOOST_CHECK_EQUAL(res16.size(), 0xFF);
+	BOOST_CHECK(std::is_sorted(res8.begin(), res8.end()));
+	BOOST_CHECK(std::is_sorted(res16.begin(), res16.end()));
+	BOOST_CHECK_EQUAL(res8.back(), 0xFF);
+}
+
+/**
+ * Wszy typ pozycji w lookup table - rekord 8B dla kluczy 32-bitowych, wynik jak dla size_t
+ */
+BOOST_AUTO_TEST_CASE(Narrow_Positions)
+{
+	typedef RadixHeap<unsigned, unsigned, std::uint16_t> heap16_t;
+	typedef RadixHeap<unsigned, unsigned, std::uint64_t> heap64_t;
+	BOOST_CHECK_EQUAL(sizeof(rheap::lookup_entry), 8);
+	BOOST_CHECK_EQUAL(sizeof(heap16_t::lookup_entry), 8);
+
+	const unsigned N = 5000;
+	heap16_t heap16(N);
+	heap64_t heap64(N);
+	std::mt19937 gen(9);
+	std::uniform_int_distribution<unsigned> dis(1000, 100000);
+	for (unsigned i = 0; i < N; ++i) {
+		const unsigned key = dis(gen);
+		heap16.push(i, key);
+		heap64.push(i, key);
+	}
+	for (unsigned i = 0; i < N; i += 3) {
+		const unsigned key = dis(gen) % 1000;
+		heap16.reduce_priority(i, key);
+		heap64.reduce_priority(i, key);
+	}
+
+	iv res16, res64;
+	while (!heap16.empty()) res16.push_back(heap16.pop().key);
+	while (!heap64.empty()) res64.push_back(heap64.pop().key);
+	BOOST_CHECK_EQUAL(res16.size(), N);
+	BOOST_CHECK(res16 == res64);
+	BOOST_CHECK(std::is_sorted(res16.begin(), res16.end()));
+	BOOST_CHECK(!heap16.in_heap(0));
+}
+
+/**
+ * Wszystkie konfiguracje (policy) w jednym programie daj ten sam wynik
+ */
+template <class heap_t>
+iv push_pop_sequence() {
+	heap_t heap(1000);
+	std::mt19937 gen(21);
+	std::uniform_int_distribution<unsigned> dis(0, 1 << 20);
+	iv res;
+	// Klucze nie mniejsze ni ostatnio zdjty
+	unsigned last = 0;
+	for (unsigned i = 0; i < 1000; ++i) {
+		heap.push(i, last + dis(gen));
+		if (i % 3 == 0) res.push_back(last = heap.pop().key);
+	}
+	while (!heap.empty()) res.push_back(heap.pop().key);
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE(Policies)
+{
+	typedef RadixHeap<unsigned, unsigned, std::uint32_t, radix::lean_policy> lean_t;
+	typedef RadixHeap<unsigned, unsigned, std::uint32_t, radix::dijkstra_policy> dijkstra_t;
+	typedef RadixHeap<unsigned, unsigned, std::uint32_t, radix::heap_policy<true, false, true, true>> soa_t;
+	typedef RadixHeap<unsigned, unsigned, std::uint32_t, radix::heap_policy<false, true, true, false>> soa_lean_t;
+	const iv expected = push_pop_sequence<dijkstra_t>();
+	BOOST_CHECK(std::is_sorted(expected.begin(), expected.end()));
+	BOOST_CHECK(push_pop_sequence<lean_t>() == expected);
+	BOOST_CHECK(push_pop_sequence<soa_t>() == expected);
+	BOOST_CHECK(push_pop_sequence<soa_lean_t>() == expected);
+
+	// Bez lookup table wartoci nie musz by liczbami
+	RadixHeap<std::string, unsigned, std::uint32_t, radix::lean_policy> strings;
+	strings.push("b", 2);
+	strings.emplace(1, 3, 'a');
+	BOOST_CHECK_EQUAL(strings.pop().value, "aaa");
+	BOOST_CHECK_EQUAL(strings.pop().value, "b");
+}
+
+/**
+ * key_traits - odwzorowanie zachowuje porzdek i jest odwracalne (rwnie dla wartoci granicznych)
+ */
+template <class key_t>
+void check_key_order(std::vector<key_t> keys)
+{
+	typedef radix::key_traits<key_t> traits_t;
+	std::sort(keys.begin(), keys.end());
+	for (size_t i = 0; i < keys.size(); ++i) {
+		BOOST_CHECK(traits_t::decode(traits_t::encode(keys[i])) == keys[i]);
+		if (i > 0) BOOST_CHECK_EQUAL(keys[i - 1] < keys[i], traits_t::encode(keys[i - 1]) < traits_t::encode(keys[i]));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Key_Traits)
+{
+	check_key_order<int>({ std::numeric_limits<int>::min(), -1000, -1, 0, 1, 7, std::numeric_limits<int>::max() });
+	check_key_order<std::int64_t>({ std::numeric_limits<std::int64_t>::min(), -(1ll << 40), -1, 0, 1ll << 40 });
+	check_key_order<std::int8_t>({ -128, -1, 0, 1, 127 });
+	check_key_order<float>({ -std::numeric_limits<float>::infinity(), -1e30f, -2.5f, -std::numeric_limits<float>::denorm_min(),
+		0.f, std::numeric_limits<float>::denorm_min(), 1e-30f, 0.5f, 2.5f, 1e30f, std::numeric_limits<float>::infinity() });
+	check_key_order<double>({ -std::numeric_limits<double>::max(), -1.0, -1e-300, 0.0, 1e-300, 1.0, 3.0,
+		std::numeric_limits<double>::max() });
+
+	// -0.0 i +0.0 to ten sam klucz
+	BOOST_CHECK_EQUAL(radix::key_traits<float>::encode(-0.f), radix::key_traits<float>::encode(0.f));
+	BOOST_CHECK_EQUAL(radix::key_traits<double>::encode(-0.0), radix::key_traits<double>::encode(0.0));
+	BOOST_CHECK_EQUAL(radix::key_traits<unsigned>::encode(5u), 5u);
+}
+
+/**
+ * mapped_queue - ujemne i zmiennoprzecinkowe klucze na kolejkach bazowych z kluczami bez znaku
+ * Klucze rosnce od wartoci ujemnych, porwnanie z posortowanym wejciem
+ */
+template <class queue_t, class key_t>
+void mapped_push_pop(const key_t start, const key_t step)
+{
+	queue_t q(1000);
+	std::mt19937 gen(31);
+	std::vector<key_t> expected, res;
+	key_t last = start;
+	for (unsigned i = 0; i < 1000; ++i) {
+		const key_t key = static_cast<key_t>(last + step * static_cast<key_t>(gen() % 100));
+		q.push(i, key);
+		expected.push_back(key);
+		if (i % 3 == 0) {
+			const auto el = q.pop();
+			res.push_back(last = el.key);
+		}
+	}
+	while (!q.empty()) res.push_back(q.pop().key);
+	std::sort(expected.begin(), expected.end());
+	BOOST_CHECK(res == expected);
+}
+
+BOOST_AUTO_TEST_CASE(Mapped_Queue)
+{
+	using radix::mapped_queue;
+	using radix::key_bits_t;
+	mapped_push_pop<mapped_queue<float, RadixHeap<unsigned, key_bits_t<float>>>>(-1000.f, 0.25f);
+	mapped_push_pop<mapped_queue<double, radix::multilevel_heap<unsigned, key_bits_t<double>>>>(-1e6, 3.5);
+	mapped_push_pop<mapped_queue<int, radix::queue<unsigned, key_bits_t<int>>>>(-100000, 7);
+	mapped_push_pop<mapped_queue<std::int64_t, radix::lookup_queue<unsigned, key_bits_t<std::int64_t>>>>(
+		-(std::int64_t(1) << 40), std::int64_t(1) << 20);
+
+	// Zmiana priorytetu i podgld - klucze w oryginalnym typie
+	mapped_queue<float, RadixHeap<unsigned, key_bits_t<float>>> q(10);
+	q.push(1, 2.5f);
+	q.push(2, -0.5f);
+	q.push(3, 10.f);
+	q.reduce_priority(3, -1.5f);
+	BOOST_CHECK_EQUAL(q.top().key, -1.5f);
+	BOOST_CHECK_EQUAL(q.pop().value, 3);
+	BOOST_CHECK(q.in_heap(1) && !q.in_heap(3));
+	BOOST_CHECK_EQUAL(q.pop().key, -0.5f);
+	BOOST_CHECK_EQUAL(q.pop().key, 2.5f);
+	BOOST_CHECK(q.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(Dijkstra)
+
+typedef graph::csr_graph<unsigned, unsigned> graph_t;
+
+/**
+ * Losowy graf + odlegoci policzone referencyjnie (std::priority_queue, "leniwe" usuwanie)
+ */
+struct graph_fixture {
+	graph_fixture() {
+		std::mt19937 gen(42);
+		std::uniform_int_distribution<unsigned> vertex(0, N - 1), weight(0, 1000);
+		std::vector<graph_t::edge> edges;
+		for (unsigned i = 0; i < N * 4; ++i) edges.push_back({ vertex(gen), vertex(gen), weight(gen) });
+		g = graph_t::from_edges(N, edges);
+
+		expected.assign(N, std::numeric_limits<unsigned>::max());
+		typedef std::pair<unsigned, unsigned> dist_vertex;
+		std::priority_queue<dist_vertex, std::vector<dist_vertex>, std::greater<dist_vertex>> q;
+		expected[0] = 0;
+		q.push(dist_vertex(0, 0));
+		while (!q.empty()) {
+			const dist_vertex top = q.top();
+			q.pop();
+			if (top.first != expected[top.second]) continue;
+			for (size_t e = g.begin(top.second); e < g.end(top.second); ++e) {
+				const unsigned d = top.first + g.weight(e);
+				if (d < expected[g.target(e)]) q.push(dist_vertex(expected[g.target(e)] = d, g.target(e)));
+			}
+		}
+	}
+
+	// Sprawdzenie odlegoci i spjnoci drzewa poprzednikw
+	void check(const std::vector<unsigned>& dist, const std::vector<unsigned>& pred) {
+		BOOST_TEST(expected == dist, boost::test_tools::per_element());
+		for (unsigned v = 1; v < N; ++v) {
+			if (dist[v] == std::numeric_limits<unsigned>::max()) continue;
+			bool edge_found = false;
+			for (size_t e = g.begin(pred[v]); e < g.end(pred[v]); ++e)
+				edge_found |= g.target(e) == v && dist[pred[v]] + g.weight(e) == dist[v];
+			BOOST_CHECK(edge_found);
+		}
+	}
+
+	static const unsigned N = 2000;
+	graph_t g;
+	std::vector<unsigned> expected;
+};
+
+BOOST_FIXTURE_TEST_CASE(Radix_Heap, graph_fixture)
+{
+	std::vector<unsigned> dist(N), pred(N);
+	graph::dijkstra<RadixHeap<unsigned, unsigned>>(g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+}
+
+BOOST_FIXTURE_TEST_CASE(DAry_Heap, graph_fixture)
+{
+	std::vector<unsigned> dist(N), pred(N);
+	graph::dijkstra<dheap<2>>(g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+	graph::dijkstra<dheap<4>>(g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+	graph::dijkstra<dheap<16>>(g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+}
+
+BOOST_FIXTURE_TEST_CASE(Lookup_Queue, graph_fixture)
+{
+	std::vector<unsigned> dist(N), pred(N);
+	graph::dijkstra<radix::lookup_queue<unsigned>>(g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+	typedef std::vector<std::pair<unsigned, unsigned>> bucket_t;
+	graph::dijkstra<radix::lookup_queue<unsigned, unsigned, bucket_t, radix::dense_lookup<unsigned, unsigned>>>(
+		g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+}
+
+BOOST_FIXTURE_TEST_CASE(Dial_Queue, graph_fixture)
+{
+	std::vector<unsigned> dist(N), pred(N);
+	graph::dijkstra<radix::dial_queue<unsigned>>(g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+
+	// Zakres mniejszy ni maksymalna waga - tablica kubekw ronie w trakcie, kolejka po reset() ponownie
+	radix::dial_queue<unsigned> heap(N, 16);
+	for (unsigned query = 0; query < 2; ++query) {
+		graph::dijkstra(heap, g, 0u, dist.data(), pred.data());
+		check(dist, pred);
+		heap.reset();
+	}
+	heap.push(3, 2);
+	heap.push(5, 2000);
+	heap.reduce_priority(5, 1);
+	BOOST_CHECK_EQUAL(heap.pop().value, 5);
+	BOOST_CHECK_EQUAL(heap.top().key, 2);
+	BOOST_CHECK(!heap.in_heap(5));
+}
+
+/**
+ * Wagi float (wielokrotnoci 1/4, wic sumy s dokadne) - kolejka z kluczami float przez key_traits
+ */
+BOOST_FIXTURE_TEST_CASE(Float_Weights, graph_fixture)
+{
+	std::vector<graph::csr_graph<float>::edge> edges;
+	for (unsigned v = 0; v < N; ++v)
+		for (size_t e = g.begin(v); e < g.end(v); ++e)
+			edges.push_back({ v, g.target(e), g.weight(e) * 0.25f });
+	const auto fg = graph::csr_graph<float>::from_edges(N, edges);
+
+	std::vector<float> dist(N);
+	std::vector<unsigned> pred(N);
+	graph::dijkstra<radix::mapped_queue<float, RadixHeap<unsigned, radix::key_bits_t<float>>>>(fg, 0u, dist.data(), pred.data());
+	for (unsigned v = 0; v < N; ++v) {
+		if (expected[v] == std::numeric_limits<unsigned>::max()) BOOST_CHECK_EQUAL(dist[v], std::numeric_limits<float>::max());
+		else BOOST_CHECK_EQUAL(dist[v], expected[v] * 0.25f);
+	}
+}
+
+/**
+ * Kolejka bez zmiany priorytetu - reduce_priority wstawia duplikat, nieaktualne wpisy pomija graph::dijkstra
+ */
+struct lazy_heap {
+	struct element {
+		unsigned key, value;
+		bool operator>(const element& other) const { return key > other.key; }
+	};
+
+	explicit lazy_heap(const size_t) {}
+	void push(const unsigned value, const unsigned key) { _heap.push(element{ key, value }); }
+	void reduce_priority(const unsigned value, const unsigned key) { push(value, key); }
+	element pop() {
+		const element res = _heap.top();
+		_heap.pop();
+		return res;
+	}
+	bool empty() const { return _heap.empty(); }
+
+	std::priority_queue<element, std::vector<element>, std::greater<element>> _heap;
+};
+
+BOOST_FIXTURE_TEST_CASE(Lazy_Heap, graph_fixture)
+{
+	std::vector<unsigned> dist(N), pred(N);
+	const size_t settled = graph::dijkstra<lazy_heap>(g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+	BOOST_CHECK_EQUAL(settled, static_cast<size_t>(std::count_if(expected.begin(), expected.end(),
+		[](const unsigned d) { return d != std::numeric_limits<unsigned>::max(); })));
+}
+
+BOOST_FIXTURE_TEST_CASE(Multilevel_Heap, graph_fixture)
+{
+	std::vector<unsigned> dist(N), pred(N);
+	graph::dijkstra<radix::multilevel_heap<unsigned, unsigned>>(g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+	graph::dijkstra<radix::multilevel_heap<unsigned, unsigned, 2>>(g, 0u, dist.data(), pred.data());
+	check(dist, pred);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(Vector)
+
+BOOST_AUTO_TEST_CASE(Clear_Keeps_Capacity)
+{
+	vector<unsigned> v;
+	BOOST_CHECK_EQUAL(v.capacity(), 0);
+	for (unsigned i = 0; i < 1000; ++i) v.push_back(i);
+	const size_t capacity = v.capacity();
+	v.clear();
+	BOOST_CHECK(v.empty());
+	BOOST_CHECK_EQUAL(v.capacity(), capacity);
+
+	v.reserve(5000);
+	BOOST_CHECK_GE(v.capacity(), 5000);
+	v.push_back(7);
+	v.shrink_to_fit();
+	BOOST_CHECK_EQUAL(v.capacity(), 1);
+	BOOST_CHECK_EQUAL(v.pop_back(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(Swap_And_Copy)
+{
+	vector<unsigned> a, b;
+	for (unsigned i = 0; i < 100; ++i) a.push_back(i);
+	std::swap(a, b);
+	BOOST_CHECK(a.empty());
+	BOOST_CHECK_EQUAL(b.size(), 100);
+
+	vector<unsigned> c(b);
+	b[0] = 42;
+	BOOST_CHECK_EQUAL(c[0], 0);
+	BOOST_CHECK_EQUAL(c[99], 99);
+
+	vector<unsigned> d(std::move(c));
+	BOOST_CHECK_EQUAL(d.size(), 100);
+	BOOST_CHECK_EQUAL(c.size(), 0);
+}
+
+// Typy nietrywialne - konstrukcja/niszczenie elementw w niezainicjalizowanym buforze
+BOOST_AUTO_TEST_CASE(Non_Trivial_Elements)
+{
+	vector<std::string> v;
+	for (unsigned i = 0; i < 100; ++i) v.emplace_back(50, static_cast<char>('a' + i % 26));
+	v.push_back(v[0]);
+	BOOST_CHECK_EQUAL(v.size(), 101);
+	BOOST_CHECK_EQUAL(v.pop_back(), std::string(50, 'a'));
+	BOOST_CHECK_EQUAL(v.back(), std::string(50, 'a' + 99 % 26));
+
+	vector<std::string> copy(v);
+	v.clear();
+	BOOST_CHECK_EQUAL(copy.size(), 100);
+	BOOST_CHECK_EQUAL(copy[1], std::string(50, 'b'));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(Lookup_Index)
+
+/**
+ * Losowe insert/erase/find porwnywane z std::map
+ */
+template <class lookup_t, class value_t>
+void check_against_map(lookup_t& lookup, const std::vector<value_t>& ids) {
+	std::map<value_t, unsigned> expected;
+	std::mt19937 gen(11);
+	std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+	for (unsigned op = 0; op < 20000; ++op) {
+		const value_t id = ids[pick(gen)];
+		if (op % 3 == 2) {
+			lookup.erase(id);
+			expected.erase(id);
+		} else {
+			typename lookup_t::record_t& record = lookup.insert(id);
+			record.position = op;
+			record.key = op * 2;
+			expected[id] = op;
+		}
+	}
+	for (const value_t id : ids) {
+		const auto it = expected.find(id);
+		BOOST_CHECK_EQUAL(lookup.contains(id), it != expected.end());
+		if (it == expected.end()) {
+			BOOST_CHECK(lookup.find(id) == nullptr);
+			continue;
+		}
+		BOOST_REQUIRE(lookup.find(id) != nullptr);
+		BOOST_CHECK_EQUAL(lookup.find(id)->position, it->second);
+		BOOST_CHECK_EQUAL(lookup.find(id)->key, it->second * 2);
+		BOOST_CHECK_EQUAL(lookup.at(id).position, it->second);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Hash_Lookup_64bit_Ids)
+{
+	std::mt19937_64 gen(7);
+	std::vector<std::uint64_t> ids(3000);
+	for (auto& id : ids) id = gen();
+	// Identyfikatory rnice si tylko wysokimi bitami - wymagaj mieszania hasza
+	for (unsigned i = 0; i < 100; ++i) ids[i] = static_cast<std::uint64_t>(i) << 40;
+
+	// Pojemno mniejsza ni ilo identyfikatorw - wymusza powikszanie tablicy
+	radix::hash_lookup<std::uint64_t, unsigned> lookup(100);
+	check_against_map(lookup, ids);
+	lookup.clear();
+	BOOST_CHECK_EQUAL(lookup.size(), 0);
+	BOOST_CHECK(!lookup.contains(ids[0]));
+}
+
+BOOST_AUTO_TEST_CASE(Dense_Lookup)
+{
+	std::vector<unsigned> ids(2000);
+	for (unsigned i = 0; i < ids.size(); ++i) ids[i] = i;
+	radix::dense_lookup<unsigned, unsigned> lookup(ids.size());
+	check_against_map(lookup, ids);
+	BOOST_CHECK(!lookup.contains(5000));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(Radix_Queue)
+
+BOOST_AUTO_TEST_CASE(Push_Pop)
+{
+	radix::queue<unsigned> q;
+	const unsigned keys[] = { 7, 58, 59, 13, 8, 49, 51, 23, 7 };
+	for (unsigned i = 0; i < 9; ++i) q.push(i, keys[i]);
+	BOOST_CHECK_EQUAL(q.top().second, 7);
+	iv res;
+	while (!q.empty()) res.push_back(q.pop().second);
+	BOOST_CHECK(res == iv({ 7, 7, 8, 13, 23, 49, 51, 58, 59 }));
+}
+
+BOOST_AUTO_TEST_CASE(Reset)
+{
+	radix::lookup_queue<unsigned, unsigned> q(16);
+	for (unsigned i = 0; i < 100; ++i) q.push(i, 1000 + i);
+	q.pop();
+	q.reset();
+	BOOST_CHECK(q.empty());
+	BOOST_CHECK(!q.in_heap(50));
+	q.push(50, 3);
+	q.push(7, 1);
+	BOOST_CHECK_EQUAL(q.pop().first, 7);
+	BOOST_CHECK_EQUAL(q.pop().second, 3);
+}
+
+BOOST_AUTO_TEST_CASE(Merge)
+{
+	radix::lookup_queue<unsigned, unsigned> a(16), b(16);
+	const unsigned keys[] = { 7, 58, 59, 13, 8, 49, 51, 23, 7, 1000, 40, 12 };
+	for (unsigned i = 0; i < 12; ++i) (i % 3 ? a : b).push(i, keys[i]);
+	BOOST_CHECK_EQUAL(a.pop().second, 7);
+	BOOST_CHECK_EQUAL(a.pop().second, 8);
+	BOOST_CHECK_EQUAL(b.pop().second, 7);
+	a.merge(b);
+	BOOST_CHECK(b.empty());
+	BOOST_CHECK(!b.in_heap(9));
+	BOOST_CHECK(a.in_heap(9));
+	a.change_priority(9, 7);
+	iv res;
+	while (!a.empty()) res.push_back(a.pop().second);
+	BOOST_CHECK(res == iv({ 7, 12, 13, 23, 40, 49, 51, 58, 59 }));
+}
+
+/**
+ * Losowe push/pop/change_priority (w obie strony) na 64-bitowych identyfikatorach,
+ * porwnywane z kolejk referencyjn (std::map klucz -> ilo)
+ */
+BOOST_AUTO_TEST_CASE(Lookup_Queue_Random)
+{
+	radix::lookup_queue<std::uint64_t, unsigned> q(64);
+	std::map<std::uint64_t, unsigned> keys;
+	std::multiset<unsigned> expected;
+	std::mt19937_64 gen(13);
+	unsigned last = 0;
+	for (unsigned op = 0; op < 30000; ++op) {
+		const unsigned action = gen() % 4;
+		if (action == 0 && !q.empty()) {
+			const auto el = q.pop();
+			BOOST_REQUIRE_EQUAL(el.second, *expected.begin());
+			BOOST_REQUIRE_EQUAL(keys[el.first], el.second);
+			expected.erase(expected.begin());
+			keys.erase(el.first);
+			BOOST_CHECK(!q.in_heap(el.first));
+			last = el.second;
+		} else if (action == 1 && !keys.empty()) {
+			auto it = keys.begin();
+			std::advance(it, gen() % keys.size());
+			const unsigned new_key = last + static_cast<unsigned>(gen() % 5000);
+			expected.erase(expected.find(it->second));
+			expected.insert(new_key);
+			it->second = new_key;
+			q.change_priority(it->first, new_key);
+		} else {
+			const std::uint64_t id = gen();
+			const unsigned key = last + static_cast<unsigned>(gen() % 5000);
+			q.push(id, key);
+			keys[id] = key;
+			expected.insert(key);
+		}
+		BOOST_REQUIRE_EQUAL(q.size(), expected.size());
+	}
+	while (!q.empty()) {
+		BOOST_REQUIRE_EQUAL(q.pop().second, *expected.begin());
+		expected.erase(expected.begin());
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(DAry_Heap)
+
+/**
+ * Losowe push/pop/change_priority (w obie strony) porwnywane z kolejk referencyjn
+ * Zwraca ilo zdjtych elementw
+ */
+template <class heap_t>
+unsigned random_dheap_operations()
+{
+	const unsigned COUNT = 5000;
+	heap_t heap(COUNT);
+	std::vector<unsigned> keys(COUNT);
+	std::multiset<unsigned> expected;
+	std::mt19937 gen(17);
+	unsigned popped = 0;
+	for (unsigned op = 0; op < 40000; ++op) {
+		const unsigned value = gen() % COUNT, action = gen() % 3;
+		if (action == 0 && !heap.empty()) {
+			BOOST_REQUIRE_EQUAL(heap.front().key, *expected.begin());
+			const auto el = heap.pop();
+			BOOST_REQUIRE_EQUAL(el.key, *expected.begin());
+			BOOST_REQUIRE_EQUAL(keys[el.value], el.key);
+			BOOST_REQUIRE(!heap.in_heap(el.value));
+			expected.erase(expected.begin());
+			++popped;
+		} else if (heap.in_heap(value)) {
+			const unsigned key = gen() % 100000;
+			expected.erase(expected.find(keys[value]));
+			expected.insert(key);
+			if (key <= keys[value]) heap.reduce_priority(value, key);
+			else heap.change_priority(value, key);
+			keys[value] = key;
+		} else {
+			keys[value] = gen() % 100000;
+			heap.push(value, keys[value]);
+			expected.insert(keys[value]);
+		}
+		BOOST_REQUIRE_EQUAL(heap.size(), expected.size());
+	}
+	while (!heap.empty()) {
+		BOOST_REQUIRE_EQUAL(heap.pop().key, *expected.begin());
+		expected.erase(expected.begin());
+		++popped;
+	}
+	return popped;
+}
+
+BOOST_AUTO_TEST_CASE(Random_Operations)
+{
+	const unsigned popped = random_dheap_operations<dheap<2>>();
+	BOOST_CHECK_GT(popped, 0);
+	BOOST_CHECK_EQUAL(random_dheap_operations<dheap<3>>(), popped);
+	BOOST_CHECK_EQUAL(random_dheap_operations<dheap<4>>(), popped);
+	// Wersje z wektorowym wyborem dziecka
+	BOOST_CHECK_EQUAL(random_dheap_operations<dheap<8>>(), popped);
+	BOOST_CHECK_EQUAL(random_dheap_operations<dheap<16>>(), popped);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(Multilevel_Heap)
+
+/**
+ * Losowe push/pop/reduce_priority porwnywane z kolejk referencyjn (klucze monotoniczne)
+ * Klucze rozrzucone po caym zakresie typu, wic elementy przechodz przez wszystkie poziomy
+ */
+template <class heap_t, class key_t>
+void random_multilevel_operations(const key_t max_step)
+{
+	const unsigned COUNT = 5000;
+	heap_t heap(COUNT);
+	std::vector<key_t> keys(COUNT);
+	std::multiset<key_t> expected;
+	std::mt19937_64 gen(23);
+	key_t last = 0;
+	for (unsigned op = 0; op < 60000; ++op) {
+		const unsigned value = static_cast<unsigned>(gen() % COUNT), action = static_cast<unsigned>(gen() % 3);
+		if (action == 0 && !heap.empty()) {
+			BOOST_REQUIRE_EQUAL(heap.top().key, *expected.begin());
+			const auto el = heap.pop();
+			BOOST_REQUIRE_EQUAL(el.key, *expected.begin());
+			BOOST_REQUIRE_EQUAL(keys[el.value], el.key);
+			BOOST_REQUIRE(!heap.in_heap(el.value));
+			last = el.key;
+			expected.erase(expected.begin());
+		} else if (heap.in_heap(value)) {
+			const key_t key = last + static_cast<key_t>(gen() % (keys[value] - last + 1));
+			expected.erase(expected.find(keys[value]));
+			expected.insert(key);
+			heap.reduce_priority(value, key);
+			keys[value] = key;
+		} else {
+			const key_t step = static_cast<key_t>(gen() % max_step);
+			keys[value] = step > std::numeric_limits<key_t>::max() - last ? last : last + step;
+			heap.push(value, keys[value]);
+			expected.insert(keys[value]);
+		}
+		BOOST_REQUIRE_EQUAL(heap.size(), expected.size());
+	}
+	while (!heap.empty()) {
+		BOOST_REQUIRE_EQUAL(heap.pop().key, *expected.begin());
+		expected.erase(expected.begin());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Random_Operations)
+{
+	random_multilevel_operations<radix::multilevel_heap<unsigned, unsigned>>(1000u);
+	random_multilevel_operations<radix::multilevel_heap<unsigned, std::uint32_t, 3>>(1u << 24);
+	random_multilevel_operations<radix::multilevel_heap<unsigned, std::uint64_t>>(static_cast<std::uint64_t>(1) << 40);
+	random_multilevel_operations<radix::multilevel_heap<unsigned, std::uint64_t, 5>>(static_cast<std::uint64_t>(1) << 40);
+	random_multilevel_operations<radix::multilevel_heap<unsigned, std::uint16_t, 1>>(std::uint16_t(200));
+}
+
+BOOST_AUTO_TEST_CASE(Reset_And_Reuse)
+{
+	radix::multilevel_heap<unsigned, std::uint64_t> heap(100);
+	heap.push(1, 1000000000000);
+	heap.push(2, 5);
+	heap.push(3, 5);
+	BOOST_CHECK_EQUAL(heap.pop().key, 5);
+	heap.reset();
+	BOOST_CHECK(heap.empty());
+	BOOST_CHECK(!heap.in_heap(1) && !heap.in_heap(3));
+	heap.push(1, 3);
+	heap.push(4, 2);
+	BOOST_CHECK_EQUAL(heap.pop().value, 4);
+	BOOST_CHECK_EQUAL(heap.pop().value, 1);
+	BOOST_CHECK(heap.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(Sort)
+
+/**
+ * radix_heap_sort() dla kluczy bez wartoci - wynik jak std::sort
+ */
+BOOST_AUTO_TEST_CASE(Keys_Only)
+{
+	std::mt19937_64 gen(3);
+	std::vector<unsigned> keys32(20000);
+	for (auto& key : keys32) key = static_cast<unsigned>(gen() % 5000);
+	std::vector<unsigned> res32(keys32.size());
+	radix::radix_heap_sort(keys32.data(), keys32.size(), res32.data());
+	std::sort(keys32.begin(), keys32.end());
+	BOOST_CHECK(res32 == keys32);
+
+	std::vector<std::uint64_t> keys64(20000);
+	for (auto& key : keys64) key = gen();
+	std::vector<std::uint64_t> res64(keys64.size());
+	radix::radix_heap_sort(keys64.data(), keys64.size(), res64.data());
+	std::sort(keys64.begin(), keys64.end());
+	BOOST_CHECK(res64 == keys64);
+
+	// Klucze float (take ujemne) przez key_traits, wejcie z iteratora
+	std::list<float> floats;
+	for (unsigned i = 0; i < 5000; ++i) floats.push_back(static_cast<float>(static_cast<int>(gen() % 20001) - 10000) / 8);
+	std::vector<float> res_floats;
+	radix::radix_heap_sort(floats.begin(), floats.end(), std::back_inserter(res_floats));
+	std::vector<float> expected(floats.begin(), floats.end());
+	std::sort(expected.begin(), expected.end());
+	BOOST_CHECK(res_floats == expected);
+}
+
+/**
+ * Pary (klucz, warto) - klucze posortowane, kada warto przy swoim kluczu
+ */
+BOOST_AUTO_TEST_CASE(Keys_Values)
+{
+	const unsigned N = 30000;
+	std::mt19937 gen(8);
+	std::vector<int> keys(N), out_keys(N);
+	std::vector<unsigned> values(N), out_values(N);
+	for (unsigned i = 0; i < N; ++i) {
+		keys[i] = static_cast<int>(gen() % 100000) - 50000;
+		values[i] = i;
+	}
+	radix::radix_heap_sort(keys.data(), values.data(), N, out_keys.data(), out_values.data());
+	BOOST_CHECK(std::is_sorted(out_keys.begin(), out_keys.end()));
+	for (unsigned i = 0; i < N; ++i) BOOST_REQUIRE_EQUAL(keys[out_values[i]], out_keys[i]);
+	std::sort(out_values.begin(), out_values.end());
+	BOOST_CHECK(out_values == values);
+}
+
+/**
+ * Strumie prawie posortowanych znacznikw czasu (opnienie < LAG) - wypisywanie do granicy
+ * najwikszy klucz - LAG po kadym kluczu, w kolejce zostaje tylko okno niewypisanych
+ */
+BOOST_AUTO_TEST_CASE(Streaming_Drain)
+{
+	const std::uint64_t LAG = 1000;
+	std::mt19937_64 gen(12);
+	std::vector<std::uint64_t> stream(50000), res;
+	for (size_t i = 0; i < stream.size(); ++i) stream[i] = (1ull << 40) + i * 10 + gen() % LAG;
+
+	radix::sorted_drain<std::uint64_t> drain;
+	std::uint64_t newest = 0;
+	size_t max_size = 0;
+	for (const std::uint64_t key : stream) {
+		drain.push(key);
+		newest = std::max(newest, key);
+		drain.drain_until(newest - LAG, std::back_inserter(res));
+		max_size = std::max(max_size, drain.size());
+	}
+	drain.drain(std::back_inserter(res));
+	BOOST_CHECK(drain.empty());
+	BOOST_CHECK_LE(max_size, 2 * LAG / 10 + 1);
+
+	std::sort(stream.begin(), stream.end());
+	BOOST_CHECK(res == stream);
+
+	// Po reset() od nowa, take klucze mniejsze ni wczeniej wypisane
+	drain.reset();
+	drain.push(5);
+	drain.push(5);
+	drain.push(2);
+	std::vector<std::uint64_t> small;
+	drain.drain_until(4, std::back_inserter(small));
+	BOOST_CHECK_EQUAL(small.size(), 1);
+	BOOST_CHECK_EQUAL(drain.size(), 2);
+	drain.drain(std::back_inserter(small));
+	BOOST_CHECK(small == std::vector<std::uint64_t>({ 2, 5, 5 }));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+///////////////////////////////////////////////////////////////////////////////////
+BOOST_AUTO_TEST_SUITE(Allocators)
+
+/**
+ * Kolejka tworzona od nowa dla kadego zapytania na wsplnej arenie
+ * Po pierwszym przebiegu bufory s brane z list wolnych blokw - bez alokacji systemowych
+ */
+BOOST_AUTO_TEST_CASE(Reuse_Without_System_Allocations)
+{
+	typedef RadixHeap<unsigned, unsigned, std::uint32_t, radix::dijkstra_policy, radix::arena_allocator<char>> heap_t;
+	const unsigned count = 20000;
+	radix::arena arena(heap_t::memory_estimate(count));
+	size_t after_warm_up = 0;
+	for (unsigned run = 0; run < 3; ++run) {
+		heap_t heap(count, radix::arena_allocator<char>(arena));
+		std::mt19937 gen(3);
+		for (unsigned i = 0; i < count; ++i) heap.push(i, gen() % 1000000);
+		for (unsigned i = 0; i < count; i += 2) heap.reduce_priority(i, 0);
+		unsigned last = 0;
+		while (!heap.empty()) {
+			const auto el = heap.pop();
+			BOOST_REQUIRE_GE(el.key, last);
+			last = el.key;
+		}
+		if (run == 0) after_warm_up = arena.system_allocations();
+	}
+	// Pierwszy blok wystarcza na ca kolejk i nic nie jest dokadane w kolejnych przebiegach
+	BOOST_CHECK_EQUAL(after_warm_up, 1);
+	BOOST_CHECK_EQUAL(arena.system_allocations(), after_warm_up);
+}
+
+BOOST_AUTO_TEST_CASE(Soa_Buckets_And_Vector)
+{
+	radix::arena arena;
+	RadixHeap<unsigned, unsigned, std::uint32_t, radix::heap_policy<false, false, true, false>,
+		radix::arena_allocator<char>> heap(0, radix::arena_allocator<char>(arena));
+	iv res;
+	for (unsigned i = 0; i < 5000; ++i) heap.push(i, (i * 7919) % 5000);
+	while (!heap.empty()) res.push_back(heap.pop().key);
+	BOOST_CHECK(std::is_sorted(res.begin(), res.end()));
+	BOOST_CHECK_EQUAL(res.size(), 5000);
+
+	// Nietrywialne elementy - powikszanie bufora przez nowy blok z areny zamiast realloc()
+	vector<std::string, false, radix::arena_allocator<std::string>> v{ radix::arena_allocator<std::string>(arena) };
+	for (unsigned i = 0; i < 100; ++i) v.emplace_back(30, static_cast<char>('a' + i % 26));
+	BOOST_CHECK_EQUAL(v[99], std::string(30, 'a' + 99 % 26));
+	vector<std::string, false, radix::arena_allocator<std::string>> copy(v);
+	BOOST_CHECK(copy.get_allocator() == v.get_allocator());
+	BOOST_CHECK_EQUAL(copy.size(), 100);
+}
+
+#if RADIX_HAS_PMR
+/**
+ * Przypisania midzy wektorami na std::pmr::polymorphic_allocator (bez propagacji alokatora)
+ * Cel zachowuje swj memory_resource - elementy s kopiowane/przenoszone do bufora z niego
+ */
+BOOST_AUTO_TEST_CASE(Pmr_Vector_Assignment)
+{
+	typedef std::pmr::polymorphic_allocator<std::string> alloc_t;
+	radix::arena arena, other_arena;
+	radix::arena_resource resource(arena), other_resource(other_arena);
+	vector<std::string, false, alloc_t> v{ alloc_t(&resource) }, w{ alloc_t(&resource) }, x{ alloc_t(&other_resource) };
+	for (unsigned i = 0; i < 50; ++i) w.emplace_back(30, static_cast<char>('a' + i % 26));
+
+	// Ten sam resource
+	v = w;
+	BOOST_CHECK(v.get_allocator().resource() == &resource);
+	BOOST_CHECK_EQUAL(v.size(), 50);
+	BOOST_CHECK_EQUAL(v[49], w[49]);
+
+	// Inny resource - kopia i przeniesienie do bufora celu, rdo przeniesienia jest puste
+	x = v;
+	BOOST_CHECK(x.get_allocator().resource() == &other_resource);
+	BOOST_CHECK_EQUAL(x[10], v[10]);
+	x.clear();
+	const size_t allocations = other_arena.system_allocations();
+	x = std::move(w);
+	BOOST_CHECK(x.get_allocator().resource() == &other_resource);
+	BOOST_CHECK_EQUAL(x.size(), 50);
+	BOOST_CHECK_EQUAL(x[49], v[49]);
+	BOOST_CHECK(w.empty());
+	BOOST_CHECK_EQUAL(other_arena.system_allocations(), allocations);
+
+	// Przeniesienie przy rwnych resource - przejcie bufora
+	const std::string* buffer = v.data();
+	w = std::move(v);
+	BOOST_CHECK_EQUAL(w.data(), buffer);
+	BOOST_CHECK(v.empty());
+}
+#endif
+
+/**
+ * Lookup table i kubeki ponad HUGE_PAGE_SIZE mapowane na duych stronach (wze NUMA wtku)
+ * Mapowana lookup table jest wyzerowana przez system, kopiec d-arny na tym samym alokatorze
+ */
+BOOST_AUTO_TEST_CASE(Huge_Page_Allocator)
+{
+	const unsigned COUNT = 1u << 19;
+	RadixHeap<unsigned, unsigned, std::uint32_t, radix::dijkstra_policy, radix::huge_page_allocator<char>> heap(COUNT);
+	std::mt19937 gen(17);
+	for (unsigned i = 0; i < COUNT; i += 2) BOOST_REQUIRE(!heap.in_heap(i));
+	for (unsigned i = 0; i < COUNT; ++i) heap.push(i, gen() % (1 << 20));
+	heap.reduce_priority(COUNT - 1, 0);
+	BOOST_CHECK_EQUAL(heap.pop().value, COUNT - 1);
+	unsigned last = 0, popped = 1;
+	while (!heap.empty()) {
+		const unsigned key = heap.pop().key;
+		BOOST_REQUIRE_GE(key, last);
+		last = key;
+		++popped;
+	}
+	BOOST_CHECK_EQUAL(popped, COUNT);
+
+	dheap<4, radix::huge_page_allocator<char>> dh(COUNT, radix::huge_page_allocator<char>(radix::memory::NO_NUMA_NODE));
+	for (unsigned i = 0; i < COUNT; ++i) dh.push(i, COUNT - i);
+	dh.build_heap();
+	BOOST_CHECK_EQUAL(dh.pop().value, COUNT - 1);
+	BOOST_CHECK_EQUAL(dh.pop().key, 2);
+
+	// Wze, do ktrego nie da si przypi - blok zmapowany bez przypicia, poraka policzona
+#if defined(__linux__)
+	const size_t failures = radix::memory::numa_bind_failures();
+	radix::huge_page_allocator<char> alloc(4096);
+	char *p = alloc.allocate(radix::memory::HUGE_PAGE_SIZE);
+	BOOST_REQUIRE(p);
+	p[0] = p[radix::memory::HUGE_PAGE_SIZE - 1] = 1;
+	alloc.deallocate(p, radix::memory::HUGE_PAGE_SIZE);
+	BOOST_CHECK_EQUAL(radix::memory::numa_bind_failures(), failures + 1);
+#endif
+}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,11 +1,19 @@
 #pragma once
+#include "arena.h"
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <ostream>
 #include <cassert>
+#include <type_traits>
+#include <utility>
 
 /**
  * Czy kontener ma automatycznie zmniejsza swoj objto wraz z ubytkiem elementw?
  * Znacznie spowalnia, ale oszczdza pami, ktra jest zwalniana z niszczeniem kontenera
+ * Domylna warto parametru auto_shrink wektora, mona j zmieni dla pojedynczego typu
  */
 #ifndef AUTO_RESIZE_DOWN
 	#define AUTO_RESIZE_DOWN 0
@@ -16,88 +24,391 @@
  * Cz podstawowego API zachowana, niepotrzebne elementy niezaimplementowane
  * Dziki uproszczeniu implementacji jest zauwaalnie szybszy od std::vector
  *
+ * Bufor nie jest inicjalizowany - elementy s konstruowane dopiero przy wstawianiu
+ * Dla typw trywialnie kopiowalnych (np. element kolejki) powikszanie bufora to realloc(),
+ * a kopiowanie to memcpy(), bez ptli po elementach
+ * Pierwsza alokacja nastpuje dopiero przy pierwszym wstawieniu (puste kubeki nie zajmuj pamici)
+ * auto_shrink - zmniejszanie bufora przy pop_back() (AUTO_RESIZE_DOWN)
+ * allocator_t - alokator zgodny z std::allocator_traits (np. radix::arena_allocator,
+ * std::pmr::polymorphic_allocator), przepinany (rebind) na T. Jeli alokator ma reallocate()
+ * (radix::malloc_allocator - realloc(), radix::huge_page_allocator - mremap()), bufor typw trywialnych
+ * jest powikszany przez niego, dla pozostaych powikszenie to nowy bufor + memcpy()
+ *
  * Autor: Tomasz Stasiak
  */
-template<class T>
+template<class T, bool auto_shrink = AUTO_RESIZE_DOWN != 0, class allocator_t = radix::malloc_allocator<T>>
 class vector {
+	typedef typename std::allocator_traits<allocator_t>::template rebind_alloc<T> _alloc_t;
+	typedef std::allocator_traits<_alloc_t> _alloc_traits;
 public:
+	typedef _alloc_t allocator_type;
+
 	// Standardowy konstruktor
-	vector() : _size(_INIT_SIZE) { _count = 0; _buffer = new T[_size]; };
-	vector(const size_t size) : _size(size != 0 ? size : 1) { _buffer = new T[_size]; _count = 0; };
+	vector() : _buffer(nullptr), _size(0), _count(0) {}
+	explicit vector(const allocator_t& alloc) : _buffer(nullptr), _size(0), _count(0), _alloc(alloc) {}
+	explicit vector(const size_t size, const allocator_t& alloc = allocator_t())
+		: _buffer(nullptr), _size(0), _count(0), _alloc(alloc) { reserve(size); }
+	vector(const vector& other) : _buffer(nullptr), _size(0), _count(0),
+		_alloc(_alloc_traits::select_on_container_copy_construction(other._alloc)) {
+		reserve(other._count);
+		_copy_from(other._buffer, other._count, _trivial_t());
+		_count = other._count;
+	}
+	vector(vector&& other) : _buffer(other._buffer), _size(other._size), _count(other._count), _alloc(std::move(other._alloc)) {
+		other._buffer = nullptr;
+		other._size = other._count = 0;
+	}
 	~vector() {
-		delete[] _buffer;
-		_buffer = nullptr;
-	};
+		clear();
+		_release();
+	}
+	// Przypisania zgodnie z propagate_on_container_copy/move_assignment - alokator bez propagacji (np. std::pmr)
+	// zostaje na miejscu, a elementy s kopiowane/przenoszone do bufora z tego alokatora
+	vector& operator=(const vector& other) {
+		if (this == &other) return *this;
+		_copy_assign_alloc(other, typename _alloc_traits::propagate_on_container_copy_assignment());
+		clear();
+		reserve(other._count);
+		_copy_from(other._buffer, other._count, _trivial_t());
+		_count = other._count;
+		return *this;
+	}
+	vector& operator=(vector&& other) {
+		if (this == &other) return *this;
+		_move_assign(other, typename _alloc_traits::propagate_on_container_move_assignment());
+		return *this;
+	}
 	void assign(const size_t count, const T &value) {
 		clear();
-		resize(count);
+		reserve(count);
 		// Wpisywanie nowych wartoci
 		for (size_t i = 0; i < count; ++i)
-			_buffer[i] = value;
+			new (_buffer + i) T(value);
+		_count = count;
 	}
 	// Gettery
     T& operator[](const size_t pos) {
 		return _buffer[pos];
 	}
+    const T& operator[](const size_t pos) const {
+		return _buffer[pos];
+	}
+	T* data() { return _buffer; }
+	const T* data() const { return _buffer; }
+	T* begin() { return _buffer; }
+	T* end() { return _buffer + _count; }
+	const T* begin() const { return _buffer; }
+	const T* end() const { return _buffer + _count; }
 	// Objto
     bool empty() const { return _count == 0; }
     size_t size() const { return _count; }
     size_t capacity() const { return _size; }
+	// Rezerwacja miejsca na co najmniej new_size elementw
+	void reserve(const size_t new_size) {
+		if (new_size > _size) _reallocate(new_size);
+	}
+	// Zwolnienie nieuywanej pamici
+	void shrink_to_fit() {
+		if (_count == _size) return;
+		if (_count == 0) {
+			_release();
+			return;
+		}
+		_reallocate(_count);
+	}
 	// Modyfikatory
+	// Usunicie elementw, bufor zostaje do ponownego uycia
 	void clear() {
-		delete[] _buffer;
+		_destroy(0, _count, _trivial_t());
 		_count = 0;
-		_buffer = new T[_size = _INIT_SIZE];
 	}
 	void push_back(const T& el) {
-		if (_count == _size) resize(_size * _GROWTH_FACTOR);
-		_buffer[_count++] = el;
+		if (_count == _size) {
+			// el moe wskazywa na element tego wektora - kopia przed realokacj
+			T tmp(el);
+			_grow();
+			new (_buffer + _count++) T(std::move(tmp));
+			return;
+		}
+		new (_buffer + _count++) T(el);
+	}
+	void push_back(T&& el) {
+		if (_count == _size) {
+			T tmp(std::move(el));
+			_grow();
+			new (_buffer + _count++) T(std::move(tmp));
+			return;
+		}
+		new (_buffer + _count++) T(std::move(el));
+	}
+	template <class... Args>
+	void emplace_back(Args&&... args) {
+		if (_count == _size) _grow();
+		new (_buffer + _count++) T(std::forward<Args>(args)...);
 	}
 	// Troch inny sposb dziaania ni w std::vector - zamiast back() i pop_back() pop_back() zwraca zdejmowan warto
-	T& pop_back() {
-#if AUTO_RESIZE_DOWN
-		// Zmniejszenie objtoci wektora jeli nie jest potrzebna
-		if (_size / _GROWTH_FACTOR > _count * 2) resize(_size / _GROWTH_FACTOR);
-#endif
+	T pop_back() {
 		assert(_count > 0);
-		return _buffer[--_count];
+		T res(std::move(_buffer[--_count]));
+		_destroy(_count, _count + 1, _trivial_t());
+		// Zmniejszenie objtoci wektora jeli nie jest potrzebna
+		if (auto_shrink && _size / _GROWTH_FACTOR > _count * 2 && _size / _GROWTH_FACTOR >= _INIT_SIZE)
+			_reallocate(_size / _GROWTH_FACTOR);
+		return res;
 	}
 	T& back() {
 		return _buffer[_count - 1];
 	}
-	// Resize bufora do odpowiedniego rozmiaru
-	void resize(size_t new_size) {
-		if (new_size <= _INIT_SIZE) new_size = _INIT_SIZE;
-		// Resize bufora i przepisanie danych
-		T *tmp = new T[new_size];
-		for (size_t i = 0; i < _count; ++i) tmp[i] = _buffer[i];
+	// Dopisanie count elementw bez ich konstrukcji (bufor dokadnie na tyle) - tylko dla typw trywialnych,
+	// wywoujcy musi je zapisa przez data() przed odczytem
+	void append_uninitialized(const size_t count) {
+		static_assert(std::is_trivially_copyable<T>::value, "Uninitialized append requires trivially copyable type");
+		reserve(_count + count);
+		_count += count;
+	}
+	typedef T& reference;
+	typedef const T& const_reference;
+	// Zmiana iloci elementw (nowe elementy s inicjalizowane wartoci domyln)
+	void resize(const size_t new_count) {
+		if (new_count < _count) {
+			_destroy(new_count, _count, _trivial_t());
+		} else {
+			reserve(new_count);
+			for (size_t i = _count; i < new_count; ++i) new (_buffer + i) T();
+		}
+		_count = new_count;
+	}
+	void swap(vector& other) {
+		std::swap(_buffer, other._buffer);
+		std::swap(_size, other._size);
+		std::swap(_count, other._count);
+		_swap_alloc(other, typename _alloc_traits::propagate_on_container_swap());
+	}
+	allocator_type get_allocator() const {
+		return _alloc;
+	}
+protected:
+	typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> _trivial_t;
+	// Czy bufor mona powiksza przez reallocate() alokatora (typ trywialny, np. pami z malloc())
+	typedef std::integral_constant<bool, _trivial_t::value &&
+		radix::detail::has_reallocate<_alloc_t>::value> _realloc_t;
 
-		// Zamiana bufora i czyszczenie po poprzednim
-		delete[] _buffer;
-		_buffer = tmp;
+	// Powikszenie bufora (pierwsza alokacja - _INIT_SIZE elementw)
+	void _grow() {
+		_reallocate(_size ? _size * _GROWTH_FACTOR : _INIT_SIZE);
+	}
+	// Zmiana wielkoci bufora z przepisaniem danych
+	void _reallocate(const size_t new_size) {
+		assert(new_size >= _count);
+		_reallocate(new_size, _realloc_t());
 		_size = new_size;
 	}
-protected:
+	void _reallocate(const size_t new_size, std::true_type) {
+		_buffer = _alloc.reallocate(_buffer, _size, new_size);
+	}
+	void _reallocate(const size_t new_size, std::false_type) {
+		T *tmp = _alloc_traits::allocate(_alloc, new_size);
+		_move_to(tmp, _trivial_t());
+		_release();
+		_buffer = tmp;
+	}
+	// Przeniesienie elementw do nowego bufora (stary jest potem zwalniany bez niszczenia elementw)
+	void _move_to(T* dst, std::true_type) {
+		if (_count) std::memcpy(dst, _buffer, _count * sizeof(T));
+	}
+	void _move_to(T* dst, std::false_type) {
+		for (size_t i = 0; i < _count; ++i) {
+			new (dst + i) T(std::move(_buffer[i]));
+			_buffer[i].~T();
+		}
+	}
+	// Przejcie alokatora przy kopiowaniu - bufor z innego alokatora musi by zwolniony wczeniej
+	void _copy_assign_alloc(const vector& other, std::true_type) {
+		if (_alloc != other._alloc) {
+			clear();
+			_release();
+		}
+		_alloc = other._alloc;
+	}
+	void _copy_assign_alloc(const vector&, std::false_type) {}
+	// Przejcie bufora (biece elementy i bufor s zwalniane)
+	void _steal(vector& other) {
+		clear();
+		_release();
+		_buffer = other._buffer;
+		_size = other._size;
+		_count = other._count;
+		other._buffer = nullptr;
+		other._size = other._count = 0;
+	}
+	void _move_assign(vector& other, std::true_type) {
+		_steal(other);
+		_alloc = std::move(other._alloc);
+	}
+	// Bez propagacji bufor mona przej tylko od rwnego alokatora, inaczej elementy s przenoszone pojedynczo
+	void _move_assign(vector& other, std::false_type) {
+		if (_alloc == other._alloc) {
+			_steal(other);
+			return;
+		}
+		clear();
+		reserve(other._count);
+		other._move_to(_buffer, _trivial_t());
+		_count = other._count;
+		other._count = 0;
+		other._release();
+	}
+	// Alokatory bez propagacji (np. std::pmr) zostaj na miejscu - musz by rwne
+	void _swap_alloc(vector& other, std::true_type) {
+		std::swap(_alloc, other._alloc);
+	}
+	void _swap_alloc(vector& other, std::false_type) {
+		assert(_alloc == other._alloc);
+		(void)other;
+	}
+	// Zwolnienie bufora (elementy musz by ju zniszczone/przeniesione)
+	void _release() {
+		if (_buffer) _alloc_traits::deallocate(_alloc, _buffer, _size);
+		_buffer = nullptr;
+		_size = 0;
+	}
+	// Kopiowanie elementw do (zarezerwowanego) bufora
+	void _copy_from(const T* src, const size_t count, std::true_type) {
+		if (count) std::memcpy(_buffer, src, count * sizeof(T));
+	}
+	void _copy_from(const T* src, const size_t count, std::false_type) {
+		for (size_t i = 0; i < count; ++i) new (_buffer + i) T(src[i]);
+	}
+	// Niszczenie elementw z zakresu [from, to)
+	void _destroy(const size_t, const size_t, std::true_type) {}
+	void _destroy(const size_t from, const size_t to, std::false_type) {
+		for (size_t i = from; i < to; ++i) _buffer[i].~T();
+	}
+
 	// Bufor przechowujcy dane
 	T *_buffer;
 	// Wielko bufora
 	size_t _size;
 	// Rzeczysista ilo elementw
 	size_t _count;
+	// Alokator bufora
+	_alloc_t _alloc;
 	const static size_t _GROWTH_FACTOR = 2;
 	const static size_t _INIT_SIZE = 10;
 };
 
+/**
+ * Wektor elementw (warto, klucz) w ukadzie SoA - wartoci i klucze w osobnych, cigych tablicach
+ * Klucze caego kubeka mog by przetwarzane wektorowo (SIMD) bez przeplatania z wartociami
+ * API jak vector<element_t>, operator[] i back() zwracaj par referencji zamiast referencji do elementu
+ *
+ * element_t musi mie pola value/key i konstruktor (value, key)
+ */
+template<class element_t, class value_t, class key_t, bool auto_shrink = AUTO_RESIZE_DOWN != 0,
+	class allocator_t = radix::malloc_allocator<element_t>>
+class soa_vector {
+public:
+	soa_vector() {}
+	explicit soa_vector(const allocator_t& alloc) : _values(alloc), _keys(alloc) {}
+
+	// Referencja do elementu - referencje do obu tablic
+	struct reference {
+		value_t& value;
+		key_t& key;
+
+		reference& operator=(const element_t& el) {
+			value = el.value;
+			key = el.key;
+			return *this;
+		}
+		operator element_t() const & { return element_t(value, key); }
+		operator element_t() && { return element_t(std::move(value), key); }
+	};
+	typedef element_t const_reference;
+
+	// Gettery
+	reference operator[](const size_t pos) {
+		return reference{ _values[pos], _keys[pos] };
+	}
+	const_reference operator[](const size_t pos) const {
+		return element_t(_values[pos], _keys[pos]);
+	}
+	reference back() {
+		return (*this)[size() - 1];
+	}
+	// Klucze i wartoci w cigych tablicach (dla kerneli SIMD i zapisu wsadowego)
+	const key_t* keys() const { return _keys.data(); }
+	key_t* keys() { return _keys.data(); }
+	value_t* values() { return _values.data(); }
+	// Objto
+	bool empty() const { return _keys.empty(); }
+	size_t size() const { return _keys.size(); }
+	size_t capacity() const { return _keys.capacity(); }
+	void reserve(const size_t new_size) {
+		_values.reserve(new_size);
+		_keys.reserve(new_size);
+	}
+	void shrink_to_fit() {
+		_values.shrink_to_fit();
+		_keys.shrink_to_fit();
+	}
+	// Modyfikatory
+	void clear() {
+		_values.clear();
+		_keys.clear();
+	}
+	void push_back(const element_t& el) {
+		_values.push_back(el.value);
+		_keys.push_back(el.key);
+	}
+	void push_back(element_t&& el) {
+		_values.push_back(std::move(el.value));
+		_keys.push_back(el.key);
+	}
+	// Konstrukcja wartoci w miejscu - pierwszy argument to znacznik (jak w konstruktorze element_t)
+	template <class tag_t, class... Args>
+	void emplace_back(tag_t, const key_t key, Args&&... args) {
+		_values.emplace_back(std::forward<Args>(args)...);
+		_keys.push_back(key);
+	}
+	void append_uninitialized(const size_t count) {
+		_values.append_uninitialized(count);
+		_keys.append_uninitialized(count);
+	}
+	element_t pop_back() {
+		const key_t key = _keys.pop_back();
+		return element_t(_values.pop_back(), key);
+	}
+	void swap(soa_vector& other) {
+		_values.swap(other._values);
+		_keys.swap(other._keys);
+	}
+	allocator_t get_allocator() const {
+		return allocator_t(_keys.get_allocator());
+	}
+protected:
+	vector<value_t, auto_shrink, allocator_t> _values;
+	vector<key_t, auto_shrink, allocator_t> _keys;
+};
+
 
 namespace std {
 	// Specjalizacja swap dla wektora
-	template<class T>
-	void swap(::vector<T> &a, ::vector<T> &b) {}
+	template<class T, bool auto_shrink, class allocator_t>
+	void swap(::vector<T, auto_shrink, allocator_t> &a, ::vector<T, auto_shrink, allocator_t> &b) {
+		a.swap(b);
+	}
+
+	template<class element_t, class value_t, class key_t, bool auto_shrink, class allocator_t>
+	void swap(::soa_vector<element_t, value_t, key_t, auto_shrink, allocator_t> &a,
+		::soa_vector<element_t, value_t, key_t, auto_shrink, allocator_t> &b) {
+		a.swap(b);
+	}
 
 	// Specjalizacja wypisania dla wektora 
 	// JSON format
-	template<class T>
-	ostream& operator<<(std::ostream &s, ::vector<T> &v) {
+	template<class T, bool auto_shrink, class allocator_t>
+	ostream& operator<<(std::ostream &s, ::vector<T, auto_shrink, allocator_t> &v) {
 		s << "[";
 		for (size_t i = 0; i < v.size(); ++i)
 			s << v[i] << (i != v.size() - 1 ? "," : "");